@@ -93,6 +93,10 @@ SOFTWARE.
 #ifndef USE_STD_FILESYSTEM
 #include <dirent.h>
 #endif  // USE_STD_FILESYSTEM
+#ifdef __linux__
+#include <sys/inotify.h>  // directory watch, for the directory cache
+#include <unistd.h>
+#endif  // __linux__
 #define PATH_SEP '/'
 #endif  // _IGFD_UNIX_
 
@@ -117,6 +121,7 @@ SOFTWARE.
 ///////////////////////////////
 
 #ifdef USE_THUMBNAILS
+#ifndef DONT_USE_STB_IMAGE
 #ifndef DONT_DEFINE_AGAIN__STB_IMAGE_IMPLEMENTATION
 #ifndef STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -129,6 +134,7 @@ SOFTWARE.
 #endif  // STB_IMAGE_RESIZE_IMPLEMENTATION
 #endif  // DONT_DEFINE_AGAIN__STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "stb/stb_image_resize2.h"
+#endif  // DONT_USE_STB_IMAGE
 #endif  // USE_THUMBNAILS
 
 ///////////////////////////////
@@ -220,6 +226,15 @@ SOFTWARE.
 #ifndef fileNameString
 #define fileNameString "File Name:"
 #endif  // fileNameString
+#ifndef FILE_STYLE_CACHE_MAX
+#define FILE_STYLE_CACHE_MAX 200000U
+#endif  // FILE_STYLE_CACHE_MAX
+#ifndef scanningString
+#define scanningString "Scanning... %zu entries"
+#endif  // scanningString
+#ifndef readingMetadataString
+#define readingMetadataString "Reading file infos... %zu/%zu"
+#endif  // readingMetadataString
 #ifndef dirNameString
 #define dirNameString "Directory Path:"
 #endif  // dirNameString
@@ -322,6 +337,12 @@ SOFTWARE.
 #ifndef DisplayMode_ThumbailsList_ImageHeight
 #define DisplayMode_ThumbailsList_ImageHeight 32.0f
 #endif  // DisplayMode_ThumbailsList_ImageHeight
+#ifndef THUMBNAIL_WORKERS_MAX
+#define THUMBNAIL_WORKERS_MAX 8U
+#endif  // THUMBNAIL_WORKERS_MAX
+#ifndef THUMBNAIL_QUEUE_MAX
+#define THUMBNAIL_QUEUE_MAX 256U
+#endif  // THUMBNAIL_QUEUE_MAX
 #ifndef IMGUI_RADIO_BUTTON
 inline bool inRadioButton(const char* vLabel, bool vToggled) {
     bool pressed = false;
@@ -436,6 +457,117 @@ public:
 };
 
 #ifndef CUSTOM_FILESYSTEM_INCLUDE
+
+// report the watched directories whose content changed, used by the file systems below
+// inotify on linux, change notifications on windows, not supported elsewhere
+class DirectoryWatcher {
+#ifdef __linux__
+private:
+    int m_Fd = -1;
+    std::map<int, std::string> m_Paths;  // by watch descriptor
+
+public:
+    DirectoryWatcher() = default;
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+    ~DirectoryWatcher() {
+        if (m_Fd >= 0) {
+            close(m_Fd);
+        }
+    }
+    bool Watch(const std::string& vPath) {
+        if (m_Fd < 0) {
+            m_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (m_Fd < 0) return false;
+        }
+        const int wd = inotify_add_watch(m_Fd, vPath.c_str(),  //
+                                         IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF);
+        if (wd < 0) return false;
+        m_Paths[wd] = vPath;
+        return true;
+    }
+    void Unwatch(const std::string& vPath) {
+        for (auto it = m_Paths.begin(); it != m_Paths.end(); ++it) {
+            if (it->second == vPath) {
+                inotify_rm_watch(m_Fd, it->first);
+                m_Paths.erase(it);
+                return;
+            }
+        }
+    }
+    void GetChanged(std::vector<std::string>& voPaths) {
+        if (m_Fd < 0) return;
+        alignas(struct inotify_event) char buffer[4096];
+        ssize_t len = 0;
+        while ((len = read(m_Fd, buffer, sizeof(buffer))) > 0) {
+            for (char* ptr = buffer; ptr < buffer + len; ptr += sizeof(struct inotify_event) + ((struct inotify_event*)ptr)->len) {
+                const auto* event = (const struct inotify_event*)ptr;
+                if (event->mask & IN_Q_OVERFLOW) {  // events lost, so all may have changed
+                    for (const auto& path : m_Paths) {
+                        voPaths.push_back(path.second);
+                    }
+                    continue;
+                }
+                const auto it = m_Paths.find(event->wd);
+                if (it == m_Paths.end()) continue;
+                if (std::find(voPaths.begin(), voPaths.end(), it->second) == voPaths.end()) {
+                    voPaths.push_back(it->second);
+                }
+                if (event->mask & IN_IGNORED) {  // the watch was removed by the system (directory deleted)
+                    m_Paths.erase(it);
+                }
+            }
+        }
+    }
+#elif defined(_IGFD_WIN_)
+private:
+    std::map<std::string, HANDLE> m_Handles;  // by path
+
+public:
+    DirectoryWatcher() = default;
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+    ~DirectoryWatcher() {
+        for (const auto& handle : m_Handles) {
+            FindCloseChangeNotification(handle.second);
+        }
+    }
+    bool Watch(const std::string& vPath) {
+        if (m_Handles.find(vPath) != m_Handles.end()) return true;
+        const std::wstring wpath = IGFD::Utils::UTF8Decode(vPath);
+        const HANDLE handle      = FindFirstChangeNotificationW(wpath.c_str(), FALSE,  //
+                                                                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+        if (handle == INVALID_HANDLE_VALUE) return false;
+        m_Handles[vPath] = handle;
+        return true;
+    }
+    void Unwatch(const std::string& vPath) {
+        const auto it = m_Handles.find(vPath);
+        if (it != m_Handles.end()) {
+            FindCloseChangeNotification(it->second);
+            m_Handles.erase(it);
+        }
+    }
+    void GetChanged(std::vector<std::string>& voPaths) {
+        for (const auto& handle : m_Handles) {
+            if (WaitForSingleObject(handle.second, 0) == WAIT_OBJECT_0) {
+                voPaths.push_back(handle.first);
+                FindNextChangeNotification(handle.second);  // rearm
+            }
+        }
+    }
+#else
+public:
+    bool Watch(const std::string& /*vPath*/) {
+        return false;
+    }
+    void Unwatch(const std::string& /*vPath*/) {
+    }
+    void GetChanged(std::vector<std::string>& /*voPaths*/) {
+    }
+#endif
+};
+
 #ifdef USE_STD_FILESYSTEM
 
 static std::filesystem::path stringToPath(const std::string& str) {
@@ -455,6 +587,20 @@ static std::string pathToString(const std::filesystem::path& path) {
 }
 
 class FileSystemStd : public IGFD::IFileSystem {
+private:
+    DirectoryWatcher m_Watcher;
+
+public:
+    bool WatchDirectory(const std::string& vPath) override {
+        return m_Watcher.Watch(vPath);
+    }
+    void UnwatchDirectory(const std::string& vPath) override {
+        m_Watcher.Unwatch(vPath);
+    }
+    void GetChangedDirectories(std::vector<std::string>& voPaths) override {
+        m_Watcher.GetChanged(voPaths);
+    }
+
 public:
     bool IsDirectoryCanBeOpened(const std::string& vName) override {
         bool bExists = false;
@@ -552,6 +698,14 @@ public:
     }
 
     std::vector<IGFD::FileInfos> ScanDirectory(const std::string& vPath) override {
+        std::vector<IGFD::FileInfos> res;
+        ScanDirectoryByBatches(vPath, [&res](std::vector<IGFD::FileInfos>& vBatch) {
+            res.insert(res.end(), std::make_move_iterator(vBatch.begin()), std::make_move_iterator(vBatch.end()));
+            return true;
+        });
+        return res;
+    }
+    void ScanDirectoryByBatches(const std::string& vPath, const std::function<bool(std::vector<IGFD::FileInfos>&)>& vBatchFun) override {
         std::vector<IGFD::FileInfos> res;
         try {
             namespace fs          = std::filesystem;
@@ -591,17 +745,25 @@ public:
                 } catch (const std::exception& ex) {
                     std::cout << "IGFD : " << ex.what() << std::endl;
                 }
+                if (res.size() >= SCAN_BATCH_SIZE) {
+                    if (!vBatchFun(res)) return;
+                    res.clear();
+                }
             }
         } catch (const std::exception& ex) {
             std::cout << "IGFD : " << ex.what() << std::endl;
         }
-        return res;
+        if (!res.empty()) vBatchFun(res);
     }
     bool IsDirectory(const std::string& vFilePathName) override {
         namespace fs = std::filesystem;
         return fs::is_directory(stringToPath(vFilePathName));
     }
     void GetFileDateAndSize(const std::string& vFilePathName, const IGFD::FileType& vFileType, std::string& voDate, size_t& voSize) override {
+        int64_t time = 0;
+        GetFileDateSizeAndTime(vFilePathName, vFileType, voDate, voSize, time);
+    }
+    void GetFileDateSizeAndTime(const std::string& vFilePathName, const IGFD::FileType& vFileType, std::string& voDate, size_t& voSize, int64_t& voTime) override {
         namespace fs = std::filesystem;
         fs::path fpath(vFilePathName);
         try {
@@ -611,15 +773,23 @@ public:
             const auto sctp          = std::chrono::time_point_cast<std::chrono::system_clock::duration>(  //
                 lastWriteTime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
             const auto cftime        = std::chrono::system_clock::to_time_t(sctp);
-            static char timebuf[100];
-            std::strftime(timebuf, sizeof(timebuf), DateTimeFormat, std::localtime(&cftime));
+            char timebuf[100];  // not static, the scan thread call this too
+            struct tm _tm;
+#ifdef _MSC_VER
+            if (localtime_s(&_tm, &cftime)) return;
+#else   // _MSC_VER
+            if (!localtime_r(&cftime, &_tm)) return;
+#endif  // _MSC_VER
+            std::strftime(timebuf, sizeof(timebuf), DateTimeFormat, &_tm);
             voDate = timebuf;
+            voTime = (int64_t)cftime;
             // size
             if (!vFileType.isDir()) {
                 voSize = fs::file_size(fpath);
             }
         } catch (const fs::filesystem_error& e) {
             voSize = 0;
+            voTime = 0;
             voDate.clear();
         }
     }
@@ -627,6 +797,20 @@ public:
 #define FILE_SYSTEM_OVERRIDE FileSystemStd
 #else
 class FileSystemDirent : public IGFD::IFileSystem {
+private:
+    DirectoryWatcher m_Watcher;
+
+public:
+    bool WatchDirectory(const std::string& vPath) override {
+        return m_Watcher.Watch(vPath);
+    }
+    void UnwatchDirectory(const std::string& vPath) override {
+        m_Watcher.Unwatch(vPath);
+    }
+    void GetChangedDirectories(std::vector<std::string>& voPaths) override {
+        m_Watcher.GetChanged(voPaths);
+    }
+
 public:
     bool IsDirectoryCanBeOpened(const std::string& vName) override {
         if (!vName.empty()) {
@@ -759,61 +943,34 @@ public:
 
     std::vector<IGFD::FileInfos> ScanDirectory(const std::string& vPath) override {
         std::vector<IGFD::FileInfos> res;
-        struct dirent** files = nullptr;
-        size_t n              = scandir(vPath.c_str(), &files, nullptr,                         //
-                                        [](const struct dirent** a, const struct dirent** b) {  //
-                               return strcoll((*a)->d_name, (*b)->d_name);
-                           });
-        if (n && files) {
-            for (size_t i = 0; i < n; ++i) {
-                struct dirent* ent = files[i];
-                IGFD::FileType fileType;
-                switch (ent->d_type) {
-                    case DT_DIR: fileType.SetContent(IGFD::FileType::ContentType::Directory); break;
-                    case DT_REG: fileType.SetContent(IGFD::FileType::ContentType::File); break;
-#if defined(_IGFD_UNIX_) || (DT_LNK != DT_UNKNOWN)
-                    case DT_LNK:
-#endif
-                    case DT_UNKNOWN: {
-                        struct stat sb = {};
-#ifdef _IGFD_WIN_
-                        const auto wfpn = IGFD::Utils::UTF8Decode(vPath + ent->d_name);
-                        if (!_wstati64(wfpn.c_str(), &sb)) {
-#else
-                        const auto fpn = vPath + IGFD::Utils::GetPathSeparator() + ent->d_name;
-                        if (!stat(fpn.c_str(), &sb)) {
-#endif
-                            if (sb.st_mode & S_IFLNK) {
-                                fileType.SetSymLink(true);
-                                // by default if we can't figure out the target type.
-                                fileType.SetContent(IGFD::FileType::ContentType::LinkToUnknown);
-                            }
-                            if (sb.st_mode & S_IFREG) {
-                                fileType.SetContent(IGFD::FileType::ContentType::File);
-                                break;
-                            } else if (sb.st_mode & S_IFDIR) {
-                                fileType.SetContent(IGFD::FileType::ContentType::Directory);
-                                break;
-                            }
-                        }
-                        break;
-                    }
-                    default: break;  // leave it invalid (devices, etc.)
-                }
-                if (fileType.isValid()) {
-                    IGFD::FileInfos _file;
-                    _file.filePath    = vPath;
-                    _file.fileNameExt = ent->d_name;
-                    _file.fileType    = fileType;
-                    res.push_back(_file);
-                }
+        ScanDirectoryByBatches(vPath, [&res](std::vector<IGFD::FileInfos>& vBatch) {
+            res.insert(res.end(), std::make_move_iterator(vBatch.begin()), std::make_move_iterator(vBatch.end()));
+            return true;
+        });
+        return res;
+    }
+    // readdir rather than scandir : entries are reported while the directory is read, and the file manager sort them anyway
+    void ScanDirectoryByBatches(const std::string& vPath, const std::function<bool(std::vector<IGFD::FileInfos>&)>& vBatchFun) override {
+        DIR* pDir = opendir(vPath.c_str());
+        if (pDir == nullptr) return;
+        std::vector<IGFD::FileInfos> res;
+        res.reserve(SCAN_BATCH_SIZE);
+        while (struct dirent* ent = readdir(pDir)) {
+            IGFD::FileType fileType = m_GetFileType(vPath, ent);
+            if (fileType.isValid()) {
+                IGFD::FileInfos _file;
+                _file.filePath    = vPath;
+                _file.fileNameExt = ent->d_name;
+                _file.fileType    = fileType;
+                res.push_back(_file);
             }
-            for (size_t i = 0; i < n; ++i) {
-                free(files[i]);
+            if (res.size() >= SCAN_BATCH_SIZE) {
+                if (!vBatchFun(res)) break;
+                res.clear();
             }
-            free(files);
         }
-        return res;
+        (void)closedir(pDir);
+        if (!res.empty()) vBatchFun(res);
     }
     bool IsDirectory(const std::string& vFilePathName) override {
         DIR* pDir = opendir(vFilePathName.c_str());
@@ -824,6 +981,10 @@ public:
         return false;
     }
     void GetFileDateAndSize(const std::string& vFilePathName, const IGFD::FileType& vFileType, std::string& voDate, size_t& voSize) override {
+        int64_t time = 0;
+        GetFileDateSizeAndTime(vFilePathName, vFileType, voDate, voSize, time);
+    }
+    void GetFileDateSizeAndTime(const std::string& vFilePathName, const IGFD::FileType& vFileType, std::string& voDate, size_t& voSize, int64_t& voTime) override {
         struct stat statInfos{};
         int32_t result{};
 #ifdef _IGFD_WIN_
@@ -832,27 +993,65 @@ public:
 #else
         result = stat(vFilePathName.c_str(), &statInfos);
 #endif
-        static char timebuf[100];
+        char timebuf[100];  // not static, the scan thread call this too
         if (!result) {
             // date
             size_t len = 0;
-#ifdef _MSC_VER
             struct tm _tm;
+#ifdef _MSC_VER
             errno_t err = localtime_s(&_tm, &statInfos.st_mtime);
             if (!err) len = strftime(timebuf, 99, DateTimeFormat, &_tm);
 #else   // _MSC_VER
-            struct tm* _tm = localtime(&statInfos.st_mtime);
-            if (_tm) len = strftime(timebuf, 99, DateTimeFormat, _tm);
+            if (localtime_r(&statInfos.st_mtime, &_tm)) len = strftime(timebuf, 99, DateTimeFormat, &_tm);
 #endif  // _MSC_VER
             if (len) {
                 voDate = std::string(timebuf, len);
             }
+            voTime = (int64_t)statInfos.st_mtime;
             // size
             if (!vFileType.isDir()) {
                 voSize = (size_t)statInfos.st_size;
             }
         }
     }
+
+private:
+    static IGFD::FileType m_GetFileType(const std::string& vPath, const struct dirent* ent) {
+        IGFD::FileType fileType;
+        switch (ent->d_type) {
+            case DT_DIR: fileType.SetContent(IGFD::FileType::ContentType::Directory); break;
+            case DT_REG: fileType.SetContent(IGFD::FileType::ContentType::File); break;
+#if defined(_IGFD_UNIX_) || (DT_LNK != DT_UNKNOWN)
+            case DT_LNK:
+#endif
+            case DT_UNKNOWN: {
+                struct stat sb = {};
+#ifdef _IGFD_WIN_
+                const auto wfpn = IGFD::Utils::UTF8Decode(vPath + ent->d_name);
+                if (!_wstati64(wfpn.c_str(), &sb)) {
+#else
+                const auto fpn = vPath + IGFD::Utils::GetPathSeparator() + ent->d_name;
+                if (!stat(fpn.c_str(), &sb)) {
+#endif
+                    if (sb.st_mode & S_IFLNK) {
+                        fileType.SetSymLink(true);
+                        // by default if we can't figure out the target type.
+                        fileType.SetContent(IGFD::FileType::ContentType::LinkToUnknown);
+                    }
+                    if (sb.st_mode & S_IFREG) {
+                        fileType.SetContent(IGFD::FileType::ContentType::File);
+                        break;
+                    } else if (sb.st_mode & S_IFDIR) {
+                        fileType.SetContent(IGFD::FileType::ContentType::Directory);
+                        break;
+                    }
+                }
+                break;
+            }
+            default: break;  // leave it invalid (devices, etc.)
+        }
+        return fileType;
+    }
 };
 #define FILE_SYSTEM_OVERRIDE FileSystemDirent
 #endif  // USE_STD_FILESYSTEM
@@ -1189,7 +1388,7 @@ void IGFD::SearchManager::DrawSearchBar(FileDialogInternal& vFileDialogInternal)
     if (ImGui::GetItemID() == ImGui::GetActiveID()) searchInputIsActive = true;
     ImGui::PopItemWidth();
     if (edited) {
-        searchTag = searchBuffer;
+        searchTag = Utils::LowerCaseString(searchBuffer);
         vFileDialogInternal.fileManager.ApplyFilteringOnFileList(vFileDialogInternal);
     }
 }
@@ -1467,10 +1666,29 @@ void IGFD::FilterManager::SetSelectedFilterWithExt(const std::string& vFilter) {
 
 void IGFD::FilterManager::SetFileStyle(const IGFD_FileStyleFlags& vFlags, const char* vCriteria, const FileStyle& vInfos) {
     std::string _criteria                  = (vCriteria != nullptr) ? std::string(vCriteria) : "";
+    m_AddStyleCriteria(_criteria);
     m_FilesStyle[vFlags][_criteria]        = std::make_shared<FileStyle>(vInfos);
     m_FilesStyle[vFlags][_criteria]->flags = vFlags;
 }
 
+void IGFD::FilterManager::m_AddStyleCriteria(const std::string& vCriteria) {
+    m_FilesStyleCache.clear();
+    if (vCriteria.find("((") != std::string::npos && m_FilesStyleRegexes.find(vCriteria) == m_FilesStyleRegexes.end()) {
+        try {
+            m_FilesStyleRegexes.emplace(vCriteria, std::regex(vCriteria));
+        } catch (std::exception& e) {
+            const std::string msg = "IGFD : The regex \"" + vCriteria + "\" parsing was failed with msg : " + e.what();
+            throw IGFDException(msg.c_str());
+        }
+    }
+}
+
+bool IGFD::FilterManager::m_SearchStyleRegex(const std::string& vCriteria, const std::string& vText) const {
+    if (vCriteria.find("((") == std::string::npos) return false;
+    const auto it = m_FilesStyleRegexes.find(vCriteria);
+    return it != m_FilesStyleRegexes.end() && std::regex_search(vText, it->second);
+}
+
 // will be called internally
 // will not been exposed to IGFD API
 bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) const {
@@ -1478,6 +1696,19 @@ bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) c
     // maybe with a lambda fucntion for let the user use his style
     // according to his use case
     if (vFileInfos.use_count() && !m_FilesStyle.empty()) {
+        // without functors, the style only depend of the file type, ext and name, so the rescans of a directory (filter change, reopen) reuse it
+        std::string cacheKey;
+        if (m_FilesStyleFunctors.empty()) {
+            cacheKey = (vFileInfos->fileType.isDir() ? "d" : "f") + std::string(vFileInfos->fileType.isSymLink() ? "l" : "-") + vFileInfos->fileExtLevels[0] + "/" + vFileInfos->fileNameExt;
+            const auto it = m_FilesStyleCache.find(cacheKey);
+            if (it != m_FilesStyleCache.end()) {
+                vFileInfos->fileStyle = it->second;
+                return it->second.use_count() > 0;
+            }
+            if (m_FilesStyleCache.size() >= FILE_STYLE_CACHE_MAX) {
+                m_FilesStyleCache.clear();
+            }
+        }
         for (const auto& _flag : m_FilesStyle) {
             for (const auto& _file : _flag.second) {
                 if ((_flag.first & IGFD_FileStyleByTypeDir && _flag.first & IGFD_FileStyleByTypeLink && vFileInfos->fileType.isDir() && vFileInfos->fileType.isSymLink()) ||
@@ -1486,8 +1717,7 @@ bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) c
                     (_flag.first & IGFD_FileStyleByTypeFile && vFileInfos->fileType.isFile())) {
                     if (_file.first.empty()) {  // for all links
                         vFileInfos->fileStyle = _file.second;
-                    } else if (_file.first.find("((") != std::string::npos && std::regex_search(vFileInfos->fileNameExt,
-                                                                                                std::regex(_file.first))) {  // for links who are equal to style criteria
+                    } else if (m_SearchStyleRegex(_file.first, vFileInfos->fileNameExt)) {  // for links who are equal to style criteria
                         vFileInfos->fileStyle = _file.second;
                     } else if (_file.first == vFileInfos->fileNameExt) {  // for links who are equal to style criteria
                         vFileInfos->fileStyle = _file.second;
@@ -1495,7 +1725,7 @@ bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) c
                 }
 
                 if (_flag.first & IGFD_FileStyleByExtention) {
-                    if (_file.first.find("((") != std::string::npos && std::regex_search(vFileInfos->fileExtLevels[0], std::regex(_file.first))) {
+                    if (m_SearchStyleRegex(_file.first, vFileInfos->fileExtLevels[0])) {
                         vFileInfos->fileStyle = _file.second;
                     } else if (vFileInfos->SearchForExt(_file.first, false)) {
                         vFileInfos->fileStyle = _file.second;
@@ -1503,7 +1733,7 @@ bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) c
                 }
 
                 if (_flag.first & IGFD_FileStyleByFullName) {
-                    if (_file.first.find("((") != std::string::npos && std::regex_search(vFileInfos->fileNameExt, std::regex(_file.first))) {
+                    if (m_SearchStyleRegex(_file.first, vFileInfos->fileNameExt)) {
                         vFileInfos->fileStyle = _file.second;
                     } else if (_file.first == vFileInfos->fileNameExt) {
                         vFileInfos->fileStyle = _file.second;
@@ -1511,7 +1741,7 @@ bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) c
                 }
 
                 if (_flag.first & IGFD_FileStyleByContainedInFullName) {
-                    if (_file.first.find("((") != std::string::npos && std::regex_search(vFileInfos->fileNameExt, std::regex(_file.first))) {
+                    if (m_SearchStyleRegex(_file.first, vFileInfos->fileNameExt)) {
                         vFileInfos->fileStyle = _file.second;
                     } else if (vFileInfos->fileNameExt.find(_file.first) != std::string::npos) {
                         vFileInfos->fileStyle = _file.second;
@@ -1528,10 +1758,16 @@ bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) c
                 }
 
                 if (vFileInfos->fileStyle.use_count()) {
+                    if (!cacheKey.empty()) {
+                        m_FilesStyleCache[cacheKey] = vFileInfos->fileStyle;
+                    }
                     return true;
                 }
             }
         }
+        if (!cacheKey.empty()) {
+            m_FilesStyleCache[cacheKey] = nullptr;
+        }
     }
 
     return false;
@@ -1540,6 +1776,7 @@ bool IGFD::FilterManager::FillFileStyle(std::shared_ptr<FileInfos> vFileInfos) c
 void IGFD::FilterManager::SetFileStyle(const IGFD_FileStyleFlags& vFlags, const char* vCriteria, const ImVec4& vColor, const std::string& vIcon, ImFont* vFont) {
     std::string _criteria;
     if (vCriteria) _criteria = std::string(vCriteria);
+    m_AddStyleCriteria(_criteria);
     m_FilesStyle[vFlags][_criteria]        = std::make_shared<FileStyle>(vColor, vIcon, vFont);
     m_FilesStyle[vFlags][_criteria]->flags = vFlags;
 }
@@ -1609,6 +1846,8 @@ bool IGFD::FilterManager::GetFileStyle(const IGFD_FileStyleFlags& vFlags, const
 
 void IGFD::FilterManager::ClearFilesStyle() {
     m_FilesStyle.clear();
+    m_FilesStyleRegexes.clear();
+    m_FilesStyleCache.clear();
 }
 
 bool IGFD::FilterManager::IsCoveredByFilters(const FileInfos& vFileInfos, bool vIsCaseInsensitive) const {
@@ -1760,8 +1999,7 @@ std::shared_ptr<IGFD::FileInfos> IGFD::FileInfos::create() {
 bool IGFD::FileInfos::SearchForTag(const std::string& vTag) const {
     if (!vTag.empty()) {
         if (fileNameExt_optimized == "..") return true;
-        return fileNameExt_optimized.find(vTag) != std::string::npos ||  // first try without case and accents
-               fileNameExt.find(vTag) != std::string::npos;              // second if searched with case and accents
+        return fileNameExt_optimized.find(vTag) != std::string::npos;  // the tag is lower case too
     }
 
     // if tag is empty => its a special case but all is found
@@ -1850,6 +2088,11 @@ IGFD::FileManager::FileManager() {
     // m_FileSystemPtr = std::make_unique<FILE_SYSTEM_OVERRIDE>();
 }
 
+IGFD::FileManager::~FileManager() {
+    m_StopScan();
+    m_StopMetadataWorkers();
+}
+
 void IGFD::FileManager::OpenCurrentPath(const FileDialogInternal& vFileDialogInternal) {
     showDevices = false;
     ClearComposer();
@@ -1863,6 +2106,9 @@ void IGFD::FileManager::OpenCurrentPath(const FileDialogInternal& vFileDialogInt
 }
 
 void IGFD::FileManager::SortFields(const FileDialogInternal& vFileDialogInternal) {
+    if (sortingField == SortingFieldEnum::FIELD_SIZE || sortingField == SortingFieldEnum::FIELD_DATE) {
+        m_RequestAllMetadata();  // sorted again by UpdateMetadata when all are resolved
+    }
     m_SortFields(vFileDialogInternal, m_FileList, m_FilteredFileList);
 }
 
@@ -1878,6 +2124,121 @@ bool IGFD::FileManager::M_SortStrings(const FileDialogInternal& vFileDialogInter
     }
 }
 
+// sort vOrder in chunks on several threads, then merge the sorted chunks
+template <typename T_Compare>
+static void ParallelSortIndices(std::vector<uint32_t>& vOrder, T_Compare vCompare) {
+    const size_t count        = vOrder.size();
+    const size_t countThreads = (std::min)((size_t)std::thread::hardware_concurrency(), (size_t)SORT_THREADS_MAX);
+    if (count < SORT_PARALLEL_MIN_COUNT || countThreads < 2U) {
+        std::sort(vOrder.begin(), vOrder.end(), vCompare);
+        return;
+    }
+    const size_t chunkSize = (count + countThreads - 1U) / countThreads;
+    const auto itBegin     = vOrder.begin();
+    std::vector<std::thread> threads;
+    for (size_t start = chunkSize; start < count; start += chunkSize) {
+        threads.emplace_back([itBegin, start, chunkSize, count, &vCompare]() {  //
+            std::sort(itBegin + start, itBegin + (std::min)(start + chunkSize, count), vCompare);
+        });
+    }
+    std::sort(itBegin, itBegin + chunkSize, vCompare);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t width = chunkSize; width < count; width *= 2U) {
+        for (size_t start = 0U; start + width < count; start += 2U * width) {
+            std::inplace_merge(itBegin + start, itBegin + start + width, itBegin + (std::min)(start + 2U * width, count), vCompare);
+        }
+    }
+}
+
+void IGFD::FileManager::M_FillSortKeys(const std::vector<std::shared_ptr<FileInfos> >& vFileInfosList, std::vector<SortKey>& voSortKeys) {
+    voSortKeys.clear();
+    voSortKeys.reserve(vFileInfosList.size());
+    for (const auto& infos : vFileInfosList) {
+        if (!infos.use_count()) continue;
+        SortKey key;
+        key.infos = infos;
+        key.name  = &infos->fileNameExt_optimized;
+        key.ext   = &infos->fileExtLevels_optimized[0];
+        key.date  = &infos->fileModifDate;
+        key.type  = infos->fileType;
+        key.size  = infos->fileSize;
+        key.time  = infos->fileModifTime;
+        voSortKeys.push_back(key);
+    }
+}
+
+void IGFD::FileManager::M_ComputeSortOrder(const FileDialogInternal& vFileDialogInternal, const SortingFieldEnum vField, const std::vector<SortKey>& vSortKeys, std::vector<uint32_t>& voOrder) {
+    voOrder.resize(vSortKeys.size());
+    for (size_t idx = 0U; idx < voOrder.size(); ++idx) {
+        voOrder[idx] = (uint32_t)idx;
+    }
+    const SortKey* keys = vSortKeys.data();
+    if (vField == SortingFieldEnum::FIELD_FILENAME) {
+        ParallelSortIndices(voOrder, [keys, &vFileDialogInternal](uint32_t a, uint32_t b) -> bool {
+            if (keys[a].type != keys[b].type) return (keys[a].type < keys[b].type);                    // directories first
+            return M_SortStrings(vFileDialogInternal, true, false, *keys[a].name, *keys[b].name);  // names are already in lower case
+        });
+    } else if (vField == SortingFieldEnum::FIELD_TYPE) {
+        ParallelSortIndices(voOrder, [keys, &vFileDialogInternal](uint32_t a, uint32_t b) -> bool {
+            if (keys[a].type != keys[b].type) return (keys[a].type < keys[b].type);                  // directories first
+            return M_SortStrings(vFileDialogInternal, true, false, *keys[a].ext, *keys[b].ext);  // exts are already in lower case
+        });
+    } else if (vField == SortingFieldEnum::FIELD_SIZE) {
+        ParallelSortIndices(voOrder, [keys](uint32_t a, uint32_t b) -> bool {
+            if (keys[a].type != keys[b].type) return (keys[a].type < keys[b].type);  // directories first
+            return (keys[a].size < keys[b].size);
+        });
+    } else if (vField == SortingFieldEnum::FIELD_DATE) {
+        ParallelSortIndices(voOrder, [keys](uint32_t a, uint32_t b) -> bool {
+            if (keys[a].type != keys[b].type) return (keys[a].type < keys[b].type);  // directories first
+            if (keys[a].time != keys[b].time) return (keys[a].time < keys[b].time);
+            return (*keys[a].date < *keys[b].date);  // time not given by the file system
+        });
+    }
+}
+
+void IGFD::FileManager::m_ClearSortOrders() {
+    m_SortKeys.clear();
+    m_SortOrders.clear();
+    m_SortKeysMetadataDirty = false;
+}
+
+const std::vector<uint32_t>& IGFD::FileManager::m_GetFileListSortOrder(const FileDialogInternal& vFileDialogInternal, const bool vAscending) {
+    if (m_SortKeys.size() != m_FileList.size()) {  // the list was completed since the last sort
+        m_ClearSortOrders();
+        M_FillSortKeys(m_FileList, m_SortKeys);
+    } else if (m_SortKeysMetadataDirty) {  // only the sizes and the times can have changed
+        for (auto& key : m_SortKeys) {
+            key.size = key.infos->fileSize;
+            key.time = key.infos->fileModifTime;
+        }
+        m_SortOrders.erase(std::make_pair(SortingFieldEnum::FIELD_SIZE, true));
+        m_SortOrders.erase(std::make_pair(SortingFieldEnum::FIELD_SIZE, false));
+        m_SortOrders.erase(std::make_pair(SortingFieldEnum::FIELD_DATE, true));
+        m_SortOrders.erase(std::make_pair(SortingFieldEnum::FIELD_DATE, false));
+        m_SortKeysMetadataDirty = false;
+    }
+
+    const auto it = m_SortOrders.find(std::make_pair(sortingField, vAscending));
+    if (it != m_SortOrders.end()) {
+        return it->second;
+    }
+
+    auto& order            = m_SortOrders[std::make_pair(sortingField, vAscending)];
+    const auto itOpposite  = m_SortOrders.find(std::make_pair(sortingField, !vAscending));
+    if (itOpposite != m_SortOrders.end()) {  // the other direction is the reversed order
+        order.assign(itOpposite->second.rbegin(), itOpposite->second.rend());
+    } else {
+        M_ComputeSortOrder(vFileDialogInternal, sortingField, m_SortKeys, order);
+        if (!vAscending) {
+            std::reverse(order.begin(), order.end());
+        }
+    }
+    return order;
+}
+
 void IGFD::FileManager::m_SortFields(const FileDialogInternal& vFileDialogInternal, std::vector<std::shared_ptr<FileInfos> >& vFileInfosList, std::vector<std::shared_ptr<FileInfos> >& vFileInfosFilteredList) {
     if (sortingField != SortingFieldEnum::FIELD_NONE) {
         headerFileName = tableHeaderFileNameString;
@@ -1888,99 +2249,84 @@ void IGFD::FileManager::m_SortFields(const FileDialogInternal& vFileDialogIntern
         headerFileThumbnails = tableHeaderFileThumbnailsString;
 #endif  // #ifdef USE_THUMBNAILS
     }
-    if (sortingField == SortingFieldEnum::FIELD_FILENAME) {
-        if (sortingDirection[0]) {
-#ifdef USE_CUSTOM_SORTING_ICON
-            headerFileName = tableHeaderAscendingIcon + headerFileName;
-#endif                                                               // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(),  //
-                      [&vFileDialogInternal](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                          if (!a.use_count() || !b.use_count()) return false;
-                          if (a->fileType != b->fileType) return (a->fileType < b->fileType);                      // directories first
-                          return M_SortStrings(vFileDialogInternal, true, false, a->fileNameExt, b->fileNameExt);  // sort in insensitive case
-                      });
-        } else {
+
+    bool ascending = true;
 #ifdef USE_CUSTOM_SORTING_ICON
-            headerFileName = tableHeaderDescendingIcon + headerFileName;
-#endif                                                               // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(),  //
-                      [&vFileDialogInternal](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                          if (!a.use_count() || !b.use_count()) return false;
-                          if (a->fileType != b->fileType) return (a->fileType > b->fileType);                     // directories last
-                          return M_SortStrings(vFileDialogInternal, true, true, a->fileNameExt, b->fileNameExt);  // sort in insensitive case
-                      });
-        }
-    } else if (sortingField == SortingFieldEnum::FIELD_TYPE) {
-        if (sortingDirection[1]) {
+    std::string* header = nullptr;
+#endif  // USE_CUSTOM_SORTING_ICON
+    switch (sortingField) {
+        case SortingFieldEnum::FIELD_FILENAME:
+            ascending = sortingDirection[0];
 #ifdef USE_CUSTOM_SORTING_ICON
-            headerFileType = tableHeaderAscendingIcon + headerFileType;
+            header = &headerFileName;
 #endif  // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(), [&vFileDialogInternal](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                if (!a.use_count() || !b.use_count()) return false;
-                if (a->fileType != b->fileType) return (a->fileType < b->fileType);                                // directory in first
-                return M_SortStrings(vFileDialogInternal, true, false, a->fileExtLevels[0], b->fileExtLevels[0]);  // sort in sensitive case
-            });
-        } else {
+            break;
+        case SortingFieldEnum::FIELD_TYPE:
+            ascending = sortingDirection[1];
 #ifdef USE_CUSTOM_SORTING_ICON
-            headerFileType = tableHeaderDescendingIcon + headerFileType;
+            header = &headerFileType;
 #endif  // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(), [&vFileDialogInternal](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                if (!a.use_count() || !b.use_count()) return false;
-                if (a->fileType != b->fileType) return (a->fileType > b->fileType);                               // directory in last
-                return M_SortStrings(vFileDialogInternal, true, true, a->fileExtLevels[0], b->fileExtLevels[0]);  // sort in sensitive case
-            });
-        }
-    } else if (sortingField == SortingFieldEnum::FIELD_SIZE) {
-        if (sortingDirection[2]) {
+            break;
+        case SortingFieldEnum::FIELD_SIZE:
+            ascending = sortingDirection[2];
 #ifdef USE_CUSTOM_SORTING_ICON
-            headerFileSize = tableHeaderAscendingIcon + headerFileSize;
+            header = &headerFileSize;
 #endif  // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(), [](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                if (!a.use_count() || !b.use_count()) return false;
-                if (a->fileType != b->fileType) return (a->fileType < b->fileType);  // directory in first
-                return (a->fileSize < b->fileSize);                                  // else
-            });
-        } else {
+            break;
+        case SortingFieldEnum::FIELD_DATE:
+            ascending = sortingDirection[3];
 #ifdef USE_CUSTOM_SORTING_ICON
-            headerFileSize = tableHeaderDescendingIcon + headerFileSize;
+            header = &headerFileDate;
 #endif  // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(), [](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                if (!a.use_count() || !b.use_count()) return false;
-                if (a->fileType != b->fileType) return (a->fileType > b->fileType);  // directory in last
-                return (a->fileSize > b->fileSize);                                  // else
-            });
-        }
-    } else if (sortingField == SortingFieldEnum::FIELD_DATE) {
-        if (sortingDirection[3]) {
+            break;
+#ifdef USE_THUMBNAILS
+        case SortingFieldEnum::FIELD_THUMBNAILS:
+            ascending = sortingDirection[4];
 #ifdef USE_CUSTOM_SORTING_ICON
-            headerFileDate = tableHeaderAscendingIcon + headerFileDate;
+            header = &headerFileThumbnails;
 #endif  // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(), [](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                if (!a.use_count() || !b.use_count()) return false;
-                if (a->fileType != b->fileType) return (a->fileType < b->fileType);  // directory in first
-                return (a->fileModifDate < b->fileModifDate);                        // else
-            });
-        } else {
+            break;
+#endif  // USE_THUMBNAILS
+        default: break;
+    }
 #ifdef USE_CUSTOM_SORTING_ICON
-            headerFileDate = tableHeaderDescendingIcon + headerFileDate;
+    if (header != nullptr) {
+        *header = (ascending ? tableHeaderAscendingIcon : tableHeaderDescendingIcon) + *header;
+    }
 #endif  // USE_CUSTOM_SORTING_ICON
-            std::sort(vFileInfosList.begin(), vFileInfosList.end(), [](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
-                if (!a.use_count() || !b.use_count()) return false;
-                if (a->fileType != b->fileType) return (a->fileType > b->fileType);  // directory in last
-                return (a->fileModifDate > b->fileModifDate);                        // else
-            });
+
+    if (sortingField == SortingFieldEnum::FIELD_FILENAME || sortingField == SortingFieldEnum::FIELD_TYPE ||  //
+        sortingField == SortingFieldEnum::FIELD_SIZE || sortingField == SortingFieldEnum::FIELD_DATE) {
+        // the keys are compared by indices, and the order of the file list is kept for each field and direction,
+        // so switching back to an already sorted column only reorder the list
+        if (&vFileInfosList == &m_FileList) {
+            const auto& order = m_GetFileListSortOrder(vFileDialogInternal, ascending);
+            vFileInfosList.clear();
+            for (const auto& idx : order) {
+                vFileInfosList.push_back(m_SortKeys[idx].infos);
+            }
+        } else {
+            std::vector<SortKey> keys;
+            std::vector<uint32_t> order;
+            M_FillSortKeys(vFileInfosList, keys);
+            M_ComputeSortOrder(vFileDialogInternal, sortingField, keys, order);
+            if (!ascending) {
+                std::reverse(order.begin(), order.end());
+            }
+            vFileInfosList.clear();
+            for (const auto& idx : order) {
+                vFileInfosList.push_back(keys[idx].infos);
+            }
         }
     }
 #ifdef USE_THUMBNAILS
     else if (sortingField == SortingFieldEnum::FIELD_THUMBNAILS) {
+        // not cached, the thumbnails sizes change as they are loaded
         // we will compare thumbnails by :
         // 1) width
         // 2) height
 
-        if (sortingDirection[4]) {
-#ifdef USE_CUSTOM_SORTING_ICON
-            headerFileThumbnails = tableHeaderAscendingIcon + headerFileThumbnails;
-#endif  // USE_CUSTOM_SORTING_ICON
+        if (ascending) {
             std::sort(vFileInfosList.begin(), vFileInfosList.end(), [](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
                 if (!a.use_count() || !b.use_count()) return false;
                 if (a->fileType != b->fileType) return (a->fileType.isDir());  // directory in first
@@ -1990,9 +2336,6 @@ void IGFD::FileManager::m_SortFields(const FileDialogInternal& vFileDialogIntern
         }
 
         else {
-#ifdef USE_CUSTOM_SORTING_ICON
-            headerFileThumbnails = tableHeaderDescendingIcon + headerFileThumbnails;
-#endif  // USE_CUSTOM_SORTING_ICON
             std::sort(vFileInfosList.begin(), vFileInfosList.end(), [](const std::shared_ptr<FileInfos>& a, const std::shared_ptr<FileInfos>& b) -> bool {
                 if (!a.use_count() || !b.use_count()) return false;
                 if (a->fileType != b->fileType) return (!a->fileType.isDir());  // directory in last
@@ -2020,6 +2363,11 @@ bool IGFD::FileManager::m_CompleteFileInfosWithUserFileAttirbutes(const FileDial
 }
 
 void IGFD::FileManager::ClearFileLists() {
+    const bool scanFinished = (m_ScanState != nullptr && m_ScanState->finished);
+    m_StopScan();
+    m_ClearMetadataRequests();
+    m_StoreFileListInCache(scanFinished);
+    m_ClearSortOrders();
     m_FilteredFileList.clear();
     m_FileList.clear();
     m_SelectedFileNames.clear();
@@ -2031,13 +2379,13 @@ void IGFD::FileManager::ClearPathLists() {
     m_SelectedFileNames.clear();
 }
 
-void IGFD::FileManager::m_AddFile(const FileDialogInternal& vFileDialogInternal, const std::string& vPath, const std::string& vFileName, const FileType& vFileType) {
+void IGFD::FileManager::m_AddFile(const FileDialogInternal& vFileDialogInternal, const FileInfos& vScannedFile) {
     auto pInfos = FileInfos::create();
 
-    pInfos->filePath              = vPath;
-    pInfos->fileNameExt           = vFileName;
+    pInfos->filePath              = vScannedFile.filePath;
+    pInfos->fileNameExt           = vScannedFile.fileNameExt;
     pInfos->fileNameExt_optimized = Utils::LowerCaseString(pInfos->fileNameExt);
-    pInfos->fileType              = vFileType;
+    pInfos->fileType              = vScannedFile.fileType;
 
     if (pInfos->fileNameExt.empty() || (pInfos->fileNameExt == "." && !vFileDialogInternal.filterManager.dLGFilters.empty())) {  // filename empty or filename is the current dir '.' //-V807
         return;
@@ -2058,7 +2406,17 @@ void IGFD::FileManager::m_AddFile(const FileDialogInternal& vFileDialogInternal,
 
     vFileDialogInternal.filterManager.FillFileStyle(pInfos);
 
-    m_CompleteFileInfos(pInfos);
+    if (vScannedFile.metadataStatus == FileInfos::MetadataStatus::RESOLVED) {  // the stat was done by the scan thread
+        pInfos->fileModifDate = vScannedFile.fileModifDate;
+        pInfos->fileModifTime = vScannedFile.fileModifTime;
+        pInfos->fileSize      = vScannedFile.fileSize;
+        if (!pInfos->fileType.isDir()) {
+            pInfos->formatedFileSize = IGFD::Utils::FormatFileSize(pInfos->fileSize);
+        }
+        pInfos->metadataStatus = FileInfos::MetadataStatus::RESOLVED;
+    } else if (pInfos->fileNameExt == "." || pInfos->fileNameExt == "..") {
+        pInfos->metadataStatus = FileInfos::MetadataStatus::RESOLVED;  // nothing to read
+    }
 
     if (m_CompleteFileInfosWithUserFileAttirbutes(vFileDialogInternal, pInfos)) {
         m_FileList.push_back(pInfos);
@@ -2110,15 +2468,373 @@ void IGFD::FileManager::ScanDir(const FileDialogInternal& vFileDialogInternal, c
 
         ClearFileLists();
 
-        const auto& files = m_FileSystemPtr->ScanDirectory(path);
-        for (const auto& file : files) {
-            m_AddFile(vFileDialogInternal, path, file.fileNameExt, file.fileType);
+        const auto signature = m_GetFileListSignature(vFileDialogInternal);
+        if (m_LoadFileListFromCache(vFileDialogInternal, path, signature)) {
+            return;
+        }
+
+        // the listing is done in the scan thread, and picked up by UpdateScan each frame
+        // the date and size are read later for the displayed rows (see RequestFileMetadata),
+        // except when a user attributes callback is set, since it can filter on them
+        m_ScanState           = std::unique_ptr<ScanState>(new ScanState());
+        auto* scanState       = m_ScanState.get();
+        auto* fileSystem      = m_FileSystemPtr.get();
+        const bool statInScan = (vFileDialogInternal.getDialogConfig().userFileAttributes != nullptr);
+
+        // watched before the scan, so a change during the scan is not missed
+        // a user attributes callback can give a different result for the same files, so never cached
+        m_FileListPath      = path;
+        m_FileListSignature = signature;
+        m_FileListChanged   = false;
+        m_FileListWatched   = !statInScan && fileSystem->WatchDirectory(path);
+        scanState->thread     = std::thread([scanState, fileSystem, path, statInScan]() {
+            fileSystem->ScanDirectoryByBatches(path, [scanState, fileSystem, statInScan](std::vector<FileInfos>& vBatch) {
+                if (statInScan) {
+                    for (auto& file : vBatch) {
+                        if (file.fileNameExt != "." && file.fileNameExt != "..") {
+                            fileSystem->GetFileDateSizeAndTime(file.filePath + IGFD::Utils::GetPathSeparator() + file.fileNameExt, file.fileType, file.fileModifDate, file.fileSize, file.fileModifTime);
+                            file.metadataStatus = FileInfos::MetadataStatus::RESOLVED;
+                        }
+                    }
+                }
+                scanState->countEntries += vBatch.size();
+                {
+                    std::lock_guard<std::mutex> lock(scanState->batchesMutex);
+                    scanState->batches.push_back(std::move(vBatch));
+                }
+                vBatch.clear();
+                return !scanState->cancel;
+            });
+            scanState->done = true;
+        });
+    }
+}
+
+void IGFD::FileManager::UpdateScan(const FileDialogInternal& vFileDialogInternal) {
+    if (!m_ScanState || m_ScanState->finished) return;
+
+    std::list<std::vector<FileInfos> > batches;
+    bool scanOver = false;
+    {
+        std::lock_guard<std::mutex> lock(m_ScanState->batchesMutex);
+        size_t countEntries = 0U;
+        while (!m_ScanState->batches.empty() && countEntries < SCAN_ENTRIES_PER_FRAME) {
+            countEntries += m_ScanState->batches.front().size();
+            batches.splice(batches.end(), m_ScanState->batches, m_ScanState->batches.begin());
+        }
+        // done is set after the last push, so nothing can be left behind once both are true
+        scanOver = m_ScanState->done && m_ScanState->batches.empty();
+    }
+
+    const size_t firstNewFile = m_FileList.size();
+    for (const auto& batch : batches) {
+        for (const auto& file : batch) {
+            m_AddFile(vFileDialogInternal, file);
+        }
+    }
+
+    if (scanOver) {
+        if (m_ScanState->thread.joinable()) {
+            m_ScanState->thread.join();
+        }
+        m_ScanState->finished = true;
+        SortFields(vFileDialogInternal);  // sorted once, when the list is complete
+    } else {
+        for (size_t idx = firstNewFile; idx < m_FileList.size(); ++idx) {
+            if (m_IsShownByFiltering(vFileDialogInternal, m_FileList[idx])) {
+                m_FilteredFileList.push_back(m_FileList[idx]);
+            }
         }
+    }
+}
+
+void IGFD::FileManager::m_StopScan() {
+    if (!m_ScanState) return;
+    m_ScanState->cancel = true;
+    if (m_ScanState->thread.joinable()) {
+        m_ScanState->thread.join();
+    }
+    m_ScanState.reset();
+}
+
+bool IGFD::FileManager::IsScanRequested() const {
+    return m_ScanState != nullptr;
+}
+
+bool IGFD::FileManager::IsScanning() const {
+    return m_ScanState != nullptr && !m_ScanState->finished;
+}
+
+size_t IGFD::FileManager::GetScannedEntriesCount() const {
+    return m_ScanState ? m_ScanState->countEntries.load() : 0U;
+}
+
+std::string IGFD::FileManager::m_GetFileListSignature(const FileDialogInternal& vFileDialogInternal) const {
+    const auto flags = vFileDialogInternal.getDialogConfig().flags &  //
+                       (ImGuiFileDialogFlags_DontShowHiddenFiles | ImGuiFileDialogFlags_CaseInsensitiveExtentionFiltering | ImGuiFileDialogFlags_NaturalSorting);
+    return vFileDialogInternal.filterManager.dLGFilters + "|" + vFileDialogInternal.filterManager.GetSelectedFilter().title + "|" +  //
+           std::to_string(flags) + (dLGDirectoryMode ? "|d" : "|f");
+}
 
-        m_SortFields(vFileDialogInternal, m_FileList, m_FilteredFileList);
+void IGFD::FileManager::m_ReleaseFiles(const std::vector<std::shared_ptr<FileInfos> >& vFiles) {
+#ifdef USE_THUMBNAILS
+    for (const auto& file : vFiles) {
+        if (file.use_count()) {
+            file->thumbnailReleased = true;  // a thumbnail still loading will not get a texture
+            if (file->thumbnailInfo.isReadyToDisplay) {
+                m_ReleasedFiles.push_back(file);
+            }
+        }
+    }
+#else   // USE_THUMBNAILS
+    (void)vFiles;
+#endif  // USE_THUMBNAILS
+}
+
+void IGFD::FileManager::m_RemoveCachedDirectory(std::map<std::string, CachedDirectory>::iterator vIter) {
+    m_FileSystemPtr->UnwatchDirectory(vIter->first);
+    m_ReleaseFiles(vIter->second.files);
+    m_DirectoryCache.erase(vIter);
+}
+
+void IGFD::FileManager::m_StoreFileListInCache(const bool vComplete) {
+    if (!m_FileListPath.empty() && vComplete && m_FileListWatched && !m_FileListChanged) {
+        auto& entry                 = m_DirectoryCache[m_FileListPath];
+        entry.signature             = m_FileListSignature;
+        entry.files                 = std::move(m_FileList);
+        entry.sortKeys              = std::move(m_SortKeys);
+        entry.sortOrders            = std::move(m_SortOrders);
+        entry.sortKeysMetadataDirty = m_SortKeysMetadataDirty;
+        entry.lastUse               = ++m_DirectoryCacheUseCounter;
+        m_FileList.clear();
+        while (m_DirectoryCache.size() > DIRECTORY_CACHE_MAX) {
+            auto itOldest = m_DirectoryCache.begin();
+            for (auto it = m_DirectoryCache.begin(); it != m_DirectoryCache.end(); ++it) {
+                if (it->second.lastUse < itOldest->second.lastUse) {
+                    itOldest = it;
+                }
+            }
+            m_RemoveCachedDirectory(itOldest);
+        }
+    } else {
+        if (m_FileListWatched) {
+            m_FileSystemPtr->UnwatchDirectory(m_FileListPath);
+        }
+        m_ReleaseFiles(m_FileList);
+    }
+    m_FileListPath.clear();
+    m_FileListWatched = false;
+    m_FileListChanged = false;
+}
+
+bool IGFD::FileManager::m_LoadFileListFromCache(const FileDialogInternal& vFileDialogInternal, const std::string& vPath, const std::string& vSignature) {
+    auto it = m_DirectoryCache.find(vPath);
+    if (it == m_DirectoryCache.end()) return false;
+    if (it->second.signature != vSignature) {  // other filters, so other files
+        m_RemoveCachedDirectory(it);
+        return false;
+    }
+
+    auto& entry             = it->second;
+    m_FileList              = std::move(entry.files);
+    m_SortKeys              = std::move(entry.sortKeys);
+    m_SortOrders            = std::move(entry.sortOrders);
+    m_SortKeysMetadataDirty = entry.sortKeysMetadataDirty;
+    m_DirectoryCache.erase(it);  // the displayed directory stay watched, and go back in the cache when left
+
+    for (const auto& file : m_FileList) {
+        if (file->metadataStatus != FileInfos::MetadataStatus::RESOLVED) {
+            file->metadataStatus = FileInfos::MetadataStatus::NONE;  // the pending requests were dropped with the list
+        }
+    }
+
+    m_FileListPath      = vPath;
+    m_FileListSignature = vSignature;
+    m_FileListWatched   = true;
+    m_FileListChanged   = false;
+
+    // seen as a finished scan
+    m_ScanState               = std::unique_ptr<ScanState>(new ScanState());
+    m_ScanState->countEntries = m_FileList.size();
+    m_ScanState->done         = true;
+    m_ScanState->finished     = true;
+
+    SortFields(vFileDialogInternal);  // the orders are cached with the list, so only a reordering
+    return true;
+}
+
+void IGFD::FileManager::UpdateDirectoryCache() {
+    std::vector<std::string> paths;
+    m_FileSystemPtr->GetChangedDirectories(paths);
+    for (const auto& path : paths) {
+        if (path == m_FileListPath) {
+            m_FileListChanged = true;  // scanned again the next time
+            continue;
+        }
+        const auto it = m_DirectoryCache.find(path);
+        if (it != m_DirectoryCache.end()) {
+            m_RemoveCachedDirectory(it);
+        }
+    }
+}
+
+#ifdef USE_THUMBNAILS
+void IGFD::FileManager::TakeReleasedFiles(std::vector<std::shared_ptr<FileInfos> >& voFiles) {
+    voFiles.swap(m_ReleasedFiles);
+    m_ReleasedFiles.clear();
+}
+#endif  // USE_THUMBNAILS
+
+void IGFD::FileManager::m_StartMetadataWorkers() {
+    if (m_MetadataState) return;
+    m_MetadataState     = std::unique_ptr<MetadataState>(new MetadataState());
+    auto* metadataState = m_MetadataState.get();
+    auto* fileSystem    = m_FileSystemPtr.get();
+    for (size_t idx = 0U; idx < METADATA_WORKERS_COUNT; ++idx) {
+        metadataState->workers.emplace_back([metadataState, fileSystem]() {
+            while (true) {
+                FileMetadata result;
+                uint32_t generation = 0U;
+                {
+                    std::unique_lock<std::mutex> lock(metadataState->mutex);
+                    metadataState->cv.wait(lock, [metadataState]() {  //
+                        return metadataState->stop || !metadataState->displayed.empty() || !metadataState->background.empty();
+                    });
+                    if (metadataState->stop) return;
+                    auto& queue  = metadataState->displayed.empty() ? metadataState->background : metadataState->displayed;
+                    result.infos = queue.front();
+                    queue.pop_front();
+                    generation = metadataState->generation;
+                }
+                // filePath, fileNameExt and fileType are not modified once the file is in the list
+                const auto& infos = *result.infos;
+                fileSystem->GetFileDateSizeAndTime(infos.filePath + IGFD::Utils::GetPathSeparator() + infos.fileNameExt, infos.fileType, result.date, result.size, result.time);
+                {
+                    std::lock_guard<std::mutex> lock(metadataState->mutex);
+                    if (generation == metadataState->generation) {
+                        metadataState->done.push_back(std::move(result));
+                    }
+                }
+            }
+        });
+    }
+}
+
+void IGFD::FileManager::m_StopMetadataWorkers() {
+    if (!m_MetadataState) return;
+    {
+        std::lock_guard<std::mutex> lock(m_MetadataState->mutex);
+        m_MetadataState->stop = true;
+    }
+    m_MetadataState->cv.notify_all();
+    for (auto& worker : m_MetadataState->workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_MetadataState.reset();
+}
+
+void IGFD::FileManager::m_ClearMetadataRequests() {
+    m_CountMetadataPending = 0U;
+    m_CountMetadataBulk    = 0U;
+    if (!m_MetadataState) return;
+    std::lock_guard<std::mutex> lock(m_MetadataState->mutex);
+    m_MetadataState->displayed.clear();
+    m_MetadataState->background.clear();
+    m_MetadataState->done.clear();
+    ++m_MetadataState->generation;
+}
+
+void IGFD::FileManager::RequestFileMetadata(const std::shared_ptr<FileInfos>& vInfos, bool vDisplayed) {
+    if (!vInfos.use_count()) return;
+    const auto status = vInfos->metadataStatus;
+    if (status == FileInfos::MetadataStatus::RESOLVED || status == FileInfos::MetadataStatus::DISPLAYED) return;
+    if (status == FileInfos::MetadataStatus::PREFETCH && !vDisplayed) return;
+    if (status == FileInfos::MetadataStatus::NONE) {
+        ++m_CountMetadataPending;
+    }
+    // a prefetched row who become displayed is queued again in front, the first result wins
+    vInfos->metadataStatus = vDisplayed ? FileInfos::MetadataStatus::DISPLAYED : FileInfos::MetadataStatus::PREFETCH;
+    m_StartMetadataWorkers();
+    {
+        std::lock_guard<std::mutex> lock(m_MetadataState->mutex);
+        if (vDisplayed) {
+            m_MetadataState->displayed.push_front(vInfos);
+        } else {
+            m_MetadataState->background.push_back(vInfos);
+        }
+    }
+    m_MetadataState->cv.notify_one();
+}
+
+void IGFD::FileManager::PrefetchFilteredRowsMetadata(int vDisplayStart, int vDisplayEnd) {
+    const int count = (int)m_FilteredFileList.size();
+    for (int i = vDisplayEnd; i < ImMin(vDisplayEnd + METADATA_PREFETCH_ROWS, count); ++i) {  // below first, the usual scroll direction
+        RequestFileMetadata(m_FilteredFileList[(size_t)i], false);
+    }
+    for (int i = vDisplayStart - 1; i >= ImMax(vDisplayStart - METADATA_PREFETCH_ROWS, 0); --i) {
+        if (i < count) {
+            RequestFileMetadata(m_FilteredFileList[(size_t)i], false);
+        }
     }
 }
 
+void IGFD::FileManager::m_RequestAllMetadata() {
+    for (const auto& file : m_FileList) {
+        RequestFileMetadata(file, false);
+    }
+    // rows already queued as displayed or prefetched count too, else the list is never sorted again once they resolve
+    if (m_CountMetadataPending > 0U) {
+        m_CountMetadataBulk = m_CountMetadataPending;
+    }
+}
+
+void IGFD::FileManager::UpdateMetadata(const FileDialogInternal& vFileDialogInternal) {
+    if (!m_MetadataState) return;
+
+    std::vector<FileMetadata> done;
+    {
+        std::lock_guard<std::mutex> lock(m_MetadataState->mutex);
+        done.swap(m_MetadataState->done);
+    }
+
+    for (auto& result : done) {
+        auto& infos = *result.infos;
+        if (infos.metadataStatus == FileInfos::MetadataStatus::RESOLVED) continue;  // was queued twice
+        infos.fileModifDate = std::move(result.date);
+        infos.fileModifTime = result.time;
+        infos.fileSize      = result.size;
+        if (!infos.fileType.isDir()) {
+            infos.formatedFileSize = IGFD::Utils::FormatFileSize(infos.fileSize);
+        }
+        infos.metadataStatus = FileInfos::MetadataStatus::RESOLVED;
+        if (m_CountMetadataPending > 0U) {
+            --m_CountMetadataPending;
+        }
+        m_SortKeysMetadataDirty = true;
+    }
+
+    if (m_CountMetadataBulk > 0U && m_CountMetadataPending == 0U) {
+        m_CountMetadataBulk = 0U;
+        if (sortingField == SortingFieldEnum::FIELD_SIZE || sortingField == SortingFieldEnum::FIELD_DATE) {
+            m_SortFields(vFileDialogInternal, m_FileList, m_FilteredFileList);  // sorted with the real values
+        }
+    }
+}
+
+bool IGFD::FileManager::IsReadingMetadata() const {
+    return m_CountMetadataBulk > 0U;
+}
+
+size_t IGFD::FileManager::GetMetadataBulkCount() const {
+    return m_CountMetadataBulk;
+}
+
+size_t IGFD::FileManager::GetMetadataBulkResolvedCount() const {
+    return m_CountMetadataBulk - ImMin(m_CountMetadataPending, m_CountMetadataBulk);
+}
+
 void IGFD::FileManager::m_ScanDirForPathSelection(const FileDialogInternal& vFileDialogInternal, const std::string& vPath) {
     std::string path = vPath;
 
@@ -2159,6 +2875,7 @@ bool IGFD::FileManager::GetDevices() {
             pInfo->fileNameExt_optimized = Utils::LowerCaseString(drive.first);
             pInfo->deviceInfos           = drive.second;
             pInfo->fileType.SetContent(FileType::ContentType::Directory);
+            pInfo->metadataStatus = FileInfos::MetadataStatus::RESOLVED;  // no date and size for a device
             if (!pInfo->fileNameExt.empty()) {
                 m_FileList.push_back(pInfo);
                 showDevices = true;
@@ -2249,14 +2966,16 @@ void IGFD::FileManager::m_ApplyFilteringOnFileList(const FileDialogInternal& vFi
     vFileInfosFilteredList.clear();
     for (const auto& file : vFileInfosList) {
         if (!file.use_count()) continue;
-        bool show = true;
-        if (!file->SearchForTag(vFileDialogInternal.searchManager.searchTag))  // if search tag
-            show = false;
-        if (dLGDirectoryMode && !file->fileType.isDir()) show = false;
-        if (show) vFileInfosFilteredList.push_back(file);
+        if (m_IsShownByFiltering(vFileDialogInternal, file)) vFileInfosFilteredList.push_back(file);
     }
 }
 
+bool IGFD::FileManager::m_IsShownByFiltering(const FileDialogInternal& vFileDialogInternal, const std::shared_ptr<FileInfos>& vInfos) const {
+    if (!vInfos->SearchForTag(vFileDialogInternal.searchManager.searchTag)) return false;  // if search tag
+    if (dLGDirectoryMode && !vInfos->fileType.isDir()) return false;
+    return true;
+}
+
 void IGFD::FileManager::m_CompleteFileInfos(const std::shared_ptr<FileInfos>& vInfos) {
     if (!vInfos.use_count()) return;
 
@@ -2287,7 +3006,7 @@ void IGFD::FileManager::m_CompleteFileInfos(const std::shared_ptr<FileInfos>& vI
         fpn = vInfos->filePath + IGFD::Utils::GetPathSeparator() + vInfos->fileNameExt;
     }
 
-    m_FileSystemPtr->GetFileDateAndSize(fpn, vInfos->fileType, vInfos->fileModifDate, vInfos->fileSize);
+    m_FileSystemPtr->GetFileDateSizeAndTime(fpn, vInfos->fileType, vInfos->fileModifDate, vInfos->fileSize, vInfos->fileModifTime);
 
     if (!vInfos->fileType.isDir()) {
         vInfos->formatedFileSize = IGFD::Utils::FormatFileSize(vInfos->fileSize);
@@ -2888,11 +3607,17 @@ IGFD::ThumbnailFeature::ThumbnailFeature() {
 #endif
 }
 
-IGFD::ThumbnailFeature::~ThumbnailFeature() = default;
+IGFD::ThumbnailFeature::~ThumbnailFeature() {
+#ifdef USE_THUMBNAILS
+    m_StopThumbnailFileDatasExtraction();
+#endif
+}
 
 void IGFD::ThumbnailFeature::m_NewThumbnailFrame(FileDialogInternal& /*vFileDialogInternal*/) {
 #ifdef USE_THUMBNAILS
     m_StartThumbnailFileDatasExtraction();
+    ++m_ThumbnailFrame;
+    m_CancelHiddenThumbnails();
 #endif
 }
 
@@ -2915,91 +3640,179 @@ void IGFD::ThumbnailFeature::m_QuitThumbnailFrame(FileDialogInternal& vFileDialo
 
 #ifdef USE_THUMBNAILS
 void IGFD::ThumbnailFeature::m_StartThumbnailFileDatasExtraction() {
-    const bool res = m_ThumbnailGenerationThread.use_count() && m_ThumbnailGenerationThread->joinable();
-    if (!res) {
-        m_IsWorking                 = true;
-        m_CountFiles                = 0U;
-        m_ThumbnailGenerationThread = std::shared_ptr<std::thread>(new std::thread(&IGFD::ThumbnailFeature::m_ThreadThumbnailFileDatasExtractionFunc, this), [this](std::thread* obj_ptr) {
-            m_IsWorking = false;
-            if (obj_ptr != nullptr) {
-                m_ThumbnailFileDatasToGetCv.notify_all();
-                obj_ptr->join();
-            }
-        });
+    if (m_ThumbnailWorkers.empty()) {
+        m_IsWorking    = true;
+        m_CountFiles   = 0U;
+        m_CountPending = 0U;
+        m_CountQueued  = 0;
+        size_t countWorkers = std::thread::hardware_concurrency();
+        if (countWorkers > THUMBNAIL_WORKERS_MAX) countWorkers = THUMBNAIL_WORKERS_MAX;
+        if (countWorkers < 1U) countWorkers = 1U;
+        // the queues must exist before any worker start, they are not resized until the workers are joined
+        for (size_t idx = 0U; idx < countWorkers; ++idx) {
+            m_ThumbnailQueues.emplace_back(new ThumbnailQueue());
+        }
+        for (size_t idx = 0U; idx < countWorkers; ++idx) {
+            m_ThumbnailWorkers.emplace_back(&IGFD::ThumbnailFeature::m_ThreadThumbnailFileDatasExtractionFunc, this, idx);
+        }
     }
 }
-
 bool IGFD::ThumbnailFeature::m_StopThumbnailFileDatasExtraction() {
-    const bool res = m_ThumbnailGenerationThread.use_count() && m_ThumbnailGenerationThread->joinable();
+    const bool res = !m_ThumbnailWorkers.empty();
     if (res) {
-        m_ThumbnailGenerationThread.reset();
+        {
+            std::lock_guard<std::mutex> workersLock(m_ThumbnailWorkersMutex);
+            m_IsWorking = false;
+        }
+        m_ThumbnailWorkersCv.notify_all();
+        for (auto& worker : m_ThumbnailWorkers) {
+            worker.join();
+        }
+        m_ThumbnailWorkers.clear();
+        // the thumbnails never started will be asked again at the next display
+        for (auto& queue : m_ThumbnailQueues) {
+            for (auto& file : queue->files) {
+                file->thumbnailInfo.isLoadingOrLoaded = false;
+            }
+        }
+        m_ThumbnailQueues.clear();
+        m_CountPending = 0U;
+        m_CountQueued  = 0;
     }
     return res;
 }
-
-void IGFD::ThumbnailFeature::m_ThreadThumbnailFileDatasExtractionFunc() {
-    m_CountFiles = 0U;
-    m_IsWorking  = true;
+void IGFD::ThumbnailFeature::m_ThreadThumbnailFileDatasExtractionFunc(size_t vWorkerIdx) {
+    std::shared_ptr<FileInfos> file = nullptr;
     // infinite loop while is thread working
     while (m_IsWorking) {
-        std::unique_lock<std::mutex> thumbnailFileDatasToGetLock(m_ThumbnailFileDatasToGetMutex);
-        m_ThumbnailFileDatasToGetCv.wait(thumbnailFileDatasToGetLock);
-        if (!m_ThumbnailFileDatasToGet.empty()) {
-            std::shared_ptr<FileInfos> file = nullptr;
-            // get the first file in the list
-            file = (*m_ThumbnailFileDatasToGet.begin());
-            m_ThumbnailFileDatasToGet.pop_front();
-            thumbnailFileDatasToGetLock.unlock();
-            // retrieve datas of the texture file if its an image file
+        if (!m_PopThumbnailToLoad(vWorkerIdx, file)) {
+            std::unique_lock<std::mutex> workersLock(m_ThumbnailWorkersMutex);
+            m_ThumbnailWorkersCv.wait(workersLock, [this]() { return !m_IsWorking || m_CountQueued > 0; });
+        } else {
+            // retrieve datas of the texture file if its an image file or a file known by a user generator
             if (file.use_count()) {
                 if (file->fileType.isFile()) {  //-V522
-                    //|| file->fileExtLevels == ".hdr" => format float so in few times
-                    if (file->SearchForExts(".png,.bmp,.tga,.jpg,.jpeg,.gif,.psd,.pic,.ppm,.pgm", true)) {
-                        auto fpn       = file->filePath + IGFD::Utils::GetPathSeparator() + file->fileNameExt;
-                        int w          = 0;
-                        int h          = 0;
-                        int chans      = 0;
-                        uint8_t* datas = stbi_load(fpn.c_str(), &w, &h, &chans, STBI_rgb_alpha);
-                        if (datas != nullptr) {
-                            if (w != 0 && h != 0) {
-                                // resize with respect to glyph ratio
-                                const float ratioX = (float)w / (float)h;
-                                const float newX   = DisplayMode_ThumbailsList_ImageHeight * ratioX;
-                                float newY         = w / ratioX;
-                                if (newX < w) {
-                                    newY = DisplayMode_ThumbailsList_ImageHeight;
-                                }
-                                const auto newWidth         = (int)newX;
-                                const auto newHeight        = (int)newY;
-                                const auto newBufSize       = (size_t)(newWidth * newHeight * 4U);  //-V112 //-V1028
-                                auto resizedData            = new uint8_t[newBufSize];
-                                const auto* resizeSucceeded = stbir_resize_uint8_linear(datas, w, h, 0, resizedData, newWidth, newHeight, 0, stbir_pixel_layout::STBIR_RGBA);  //-V112
-                                if (resizeSucceeded != nullptr) {
-                                    auto th              = &file->thumbnailInfo;
-                                    th->textureFileDatas = resizedData;
-                                    th->textureWidth     = newWidth;
-                                    th->textureHeight    = newHeight;
-                                    th->textureChannels  = 4;  //-V112
-                                    // we set that at least, because will launch the gpu creation of the texture in the
-                                    // main thread
-                                    th->isReadyToUpload = true;
-                                    // need gpu loading
-                                    m_AddThumbnailToCreate(file);
-                                } else {
-                                    delete[] resizedData;
-                                }
-                            } else {
-                                printf("image loading fail : w:%i h:%i c:%i\n", w, h, 4);  //-V112
-                            }
-                            stbi_image_free(datas);
-                        }
+                    auto fpn       = file->filePath + IGFD::Utils::GetPathSeparator() + file->fileNameExt;
+                    auto th        = &file->thumbnailInfo;
+                    bool generated = false;
+                    const auto* generator = m_GetThumbnailGenerator(file);
+                    if (generator != nullptr) {
+                        generated = (*generator)(fpn, th);
+                    } else {
+                        generated = m_LoadImageThumbnail(fpn, th);
+                    }
+                    if (generated) {
+                        // we set that at least, because will launch the gpu creation of the texture in the
+                        // main thread
+                        th->isReadyToUpload = true;
+                        // need gpu loading
+                        m_AddThumbnailToCreate(file);
                     }
                 }
             }
+            file = nullptr;
+            ++m_CountFiles;
+            --m_CountPending;
+        }
+    }
+}
+
+bool IGFD::ThumbnailFeature::m_PopThumbnailToLoad(size_t vWorkerIdx, std::shared_ptr<FileInfos>& vOutFileInfos) {
+    // own queue first, from the last requests, then the oldest requests of the others workers
+    const size_t countQueues = m_ThumbnailQueues.size();
+    for (size_t offset = 0U; offset < countQueues; ++offset) {
+        auto& queue = *m_ThumbnailQueues[(vWorkerIdx + offset) % countQueues];
+        std::lock_guard<std::mutex> queueLock(queue.mutex);
+        if (!queue.files.empty()) {
+            if (offset == 0U) {
+                vOutFileInfos = queue.files.front();
+                queue.files.pop_front();
+            } else {
+                vOutFileInfos = queue.files.back();
+                queue.files.pop_back();
+            }
+            --m_CountQueued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void IGFD::ThumbnailFeature::m_CancelHiddenThumbnails() {
+    for (auto& queue : m_ThumbnailQueues) {
+        std::lock_guard<std::mutex> queueLock(queue->mutex);
+        for (auto it = queue->files.begin(); it != queue->files.end();) {
+            if ((*it)->thumbnailRequestFrame + 1U < m_ThumbnailFrame) {  // not displayed last frame
+                (*it)->thumbnailInfo.isLoadingOrLoaded = false;
+                it = queue->files.erase(it);
+                --m_CountQueued;
+                --m_CountPending;
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+bool IGFD::ThumbnailFeature::m_LoadImageThumbnail(const std::string& vFilePathName, IGFD_Thumbnail_Info* vThumbnailInfo) {
+#ifndef DONT_USE_STB_IMAGE
+    int w          = 0;
+    int h          = 0;
+    int chans      = 0;
+    uint8_t* datas = stbi_load(vFilePathName.c_str(), &w, &h, &chans, STBI_rgb_alpha);
+    if (datas == nullptr) return false;
+    bool res = false;
+    if (w != 0 && h != 0) {
+        // resize with respect to glyph ratio
+        const float ratioX = (float)w / (float)h;
+        const float newX   = DisplayMode_ThumbailsList_ImageHeight * ratioX;
+        float newY         = w / ratioX;
+        if (newX < w) {
+            newY = DisplayMode_ThumbailsList_ImageHeight;
+        }
+        const auto newWidth         = (int)newX;
+        const auto newHeight        = (int)newY;
+        const auto newBufSize       = (size_t)(newWidth * newHeight * 4U);  //-V112 //-V1028
+        auto resizedData            = new uint8_t[newBufSize];
+        const auto* resizeSucceeded = stbir_resize_uint8_linear(datas, w, h, 0, resizedData, newWidth, newHeight, 0, stbir_pixel_layout::STBIR_RGBA);  //-V112
+        if (resizeSucceeded != nullptr) {
+            vThumbnailInfo->textureFileDatas = resizedData;
+            vThumbnailInfo->textureWidth     = newWidth;
+            vThumbnailInfo->textureHeight    = newHeight;
+            vThumbnailInfo->textureChannels  = 4;  //-V112
+            res                              = true;
         } else {
-            thumbnailFileDatasToGetLock.unlock();
+            delete[] resizedData;
         }
+    } else {
+        printf("image loading fail : w:%i h:%i c:%i\n", w, h, 4);  //-V112
     }
+    stbi_image_free(datas);
+    return res;
+#else   // DONT_USE_STB_IMAGE
+    (void)vFilePathName;
+    (void)vThumbnailInfo;
+    return false;
+#endif  // DONT_USE_STB_IMAGE
+}
+
+const IGFD::ThumbnailFeature::GenerateThumbnailFun* IGFD::ThumbnailFeature::m_GetThumbnailGenerator(const std::shared_ptr<FileInfos>& vFileInfos) const {
+    for (const auto& generator : m_ThumbnailGenerators) {
+        if (vFileInfos->SearchForExts(generator.first, true)) {
+            return &generator.second;
+        }
+    }
+    return nullptr;
+}
+
+bool IGFD::ThumbnailFeature::m_CanHaveThumbnail(const std::shared_ptr<FileInfos>& vFileInfos) const {
+    if (m_GetThumbnailGenerator(vFileInfos) != nullptr) return true;
+#ifndef DONT_USE_STB_IMAGE
+    //|| file->fileExtLevels == ".hdr" => format float so in few times
+    return vFileInfos->SearchForExts(".png,.bmp,.tga,.jpg,.jpeg,.gif,.psd,.pic,.ppm,.pgm", true);
+#else   // DONT_USE_STB_IMAGE
+    return false;
+#endif  // DONT_USE_STB_IMAGE
 }
 
 void IGFD::ThumbnailFeature::m_VariadicProgressBar(float fraction, const ImVec2& size_arg, const char* fmt, ...) {
@@ -3014,34 +3827,37 @@ void IGFD::ThumbnailFeature::m_VariadicProgressBar(float fraction, const ImVec2&
 }
 
 void IGFD::ThumbnailFeature::m_DrawThumbnailGenerationProgress() {
-    if (m_ThumbnailGenerationThread.use_count() && m_ThumbnailGenerationThread->joinable()) {
-        m_ThumbnailFileDatasToGetMutex.lock();
-        if (!m_ThumbnailFileDatasToGet.empty()) {
-            const auto p = (float)((double)m_CountFiles / (double)m_ThumbnailFileDatasToGet.size());                     // read => no thread concurency issues
-            m_VariadicProgressBar(p, ImVec2(50, 0), "%u/%u", m_CountFiles, (uint32_t)m_ThumbnailFileDatasToGet.size());  // read => no thread concurency issues
-            ImGui::SameLine();
-        }
-        m_ThumbnailFileDatasToGetMutex.unlock();
-        m_ThumbnailFileDatasToGetCv.notify_all();
+    const uint32_t countPending = m_CountPending;
+    if (countPending > 0U) {
+        const uint32_t countDone = m_CountFiles;
+        const auto p             = (float)((double)countDone / (double)(countDone + countPending));
+        m_VariadicProgressBar(p, ImVec2(50, 0), "%u/%u", countDone, countDone + countPending);
+        ImGui::SameLine();
     }
 }
-
 void IGFD::ThumbnailFeature::m_AddThumbnailToLoad(const std::shared_ptr<FileInfos>& vFileInfos) {
     if (vFileInfos.use_count()) {
-        if (vFileInfos->fileType.isFile()) {
-            //|| file->fileExtLevels == ".hdr" => format float so in few times
-            if (vFileInfos->SearchForExts(".png,.bmp,.tga,.jpg,.jpeg,.gif,.psd,.pic,.ppm,.pgm", true)) {
-                // write => thread concurency issues
-                m_ThumbnailFileDatasToGetMutex.lock();
-                m_ThumbnailFileDatasToGet.push_back(vFileInfos);
-                vFileInfos->thumbnailInfo.isLoadingOrLoaded = true;
-                m_ThumbnailFileDatasToGetMutex.unlock();
+        vFileInfos->thumbnailRequestFrame = m_ThumbnailFrame;  // keep the request alive while the row is displayed
+        if (vFileInfos->thumbnailInfo.isLoadingOrLoaded || m_ThumbnailQueues.empty()) return;
+        if (vFileInfos->fileType.isFile() && m_CanHaveThumbnail(vFileInfos)) {
+            if (m_CountPending >= THUMBNAIL_QUEUE_MAX) return;  // will be asked again next frame if still displayed
+            auto& queue = *m_ThumbnailQueues[m_NextThumbnailQueue++ % m_ThumbnailQueues.size()];
+            {
+                std::lock_guard<std::mutex> queueLock(queue.mutex);
+                queue.files.push_front(vFileInfos);
+            }
+            vFileInfos->thumbnailInfo.isLoadingOrLoaded = true;
+            ++m_CountPending;
+            {
+                std::lock_guard<std::mutex> workersLock(m_ThumbnailWorkersMutex);
+                ++m_CountQueued;
             }
-            m_ThumbnailFileDatasToGetCv.notify_all();
+            m_ThumbnailWorkersCv.notify_one();
+        } else {
+            vFileInfos->thumbnailInfo.isLoadingOrLoaded = true;  // nothing to load, so no need to check again
         }
     }
 }
-
 void IGFD::ThumbnailFeature::m_AddThumbnailToCreate(const std::shared_ptr<FileInfos>& vFileInfos) {
     if (vFileInfos.use_count()) {
         // write => thread concurency issues
@@ -3076,17 +3892,13 @@ void IGFD::ThumbnailFeature::m_DrawDisplayModeToolBar() {
 }
 
 void IGFD::ThumbnailFeature::m_ClearThumbnails(FileDialogInternal& vFileDialogInternal) {
-    // directory wil be changed so the file list will be erased
-    if (vFileDialogInternal.fileManager.pathClicked) {
-        size_t count = vFileDialogInternal.fileManager.GetFullFileListSize();
-        for (size_t idx = 0U; idx < count; idx++) {
-            auto file = vFileDialogInternal.fileManager.GetFullFileAt(idx);
-            if (file.use_count()) {
-                if (file->thumbnailInfo.isReadyToDisplay)  //-V522
-                {
-                    m_AddThumbnailToDestroy(file->thumbnailInfo);
-                }
-            }
+    // files who left the file list and are not kept in the directory cache
+    std::vector<std::shared_ptr<FileInfos> > files;
+    vFileDialogInternal.fileManager.TakeReleasedFiles(files);
+    for (const auto& file : files) {
+        if (file->thumbnailInfo.isReadyToDisplay) {
+            m_AddThumbnailToDestroy(file->thumbnailInfo);
+            file->thumbnailInfo.isReadyToDisplay = false;
         }
     }
 }
@@ -3099,13 +3911,23 @@ void IGFD::ThumbnailFeature::SetDestroyThumbnailCallback(const DestroyThumbnailF
     m_DestroyThumbnailFun = vCreateThumbnailFun;
 }
 
+void IGFD::ThumbnailFeature::AddThumbnailGenerator(const std::string& vComaSepExts, const GenerateThumbnailFun& vGenerateThumbnailFun) {
+    m_ThumbnailGenerators.emplace_back(vComaSepExts, vGenerateThumbnailFun);
+}
+
 void IGFD::ThumbnailFeature::ManageGPUThumbnails() {
     if (m_CreateThumbnailFun) {
         m_ThumbnailToCreateMutex.lock();
         if (!m_ThumbnailToCreate.empty()) {
             for (const auto& file : m_ThumbnailToCreate) {
-                if (file.use_count()) {
+                if (!file.use_count()) {
+                    continue;
+                }
+                if (!file->thumbnailReleased) {
                     m_CreateThumbnailFun(&file->thumbnailInfo);
+                } else {  // the file left the list and the cache while loading, no texture will ever be destroyed for it
+                    delete[] file->thumbnailInfo.textureFileDatas;
+                    file->thumbnailInfo.textureFileDatas = nullptr;
                 }
             }
             m_ThumbnailToCreate.clear();
@@ -3860,7 +4682,10 @@ bool IGFD::FileDialog::Display(const std::string& vKey, ImGuiWindowFlags vFlags,
                 fdFilter.SetDefaultFilterIfNotDefined();
 
                 // init list of files
-                if (fdFile.IsFileListEmpty() && !fdFile.showDevices) {
+                fdFile.UpdateDirectoryCache();
+                fdFile.UpdateScan(m_FileDialogInternal);
+                fdFile.UpdateMetadata(m_FileDialogInternal);
+                if (fdFile.IsFileListEmpty() && !fdFile.showDevices && !fdFile.IsScanRequested()) {
                     if (fdFile.dLGpath != ".")                                                      // Removes extension seperator in filename if we don't check
                         IGFD::Utils::ReplaceString(fdFile.dLGDefaultFileName, fdFile.dLGpath, "");  // local path
 
@@ -4118,6 +4943,11 @@ bool IGFD::FileDialog::m_DrawFooter() {
     auto& fdFile = m_FileDialogInternal.fileManager;
 
     float posY = ImGui::GetCursorPos().y;  // height of last bar calc
+    if (fdFile.IsScanning()) {
+        ImGui::Text(scanningString, fdFile.GetScannedEntriesCount());
+    } else if (fdFile.IsReadingMetadata()) {
+        ImGui::Text(readingMetadataString, fdFile.GetMetadataBulkResolvedCount(), fdFile.GetMetadataBulkCount());
+    }
     ImGui::AlignTextToFramePadding();
     if (!fdFile.dLGDirectoryMode)
         ImGui::Text(fileNameString);
@@ -4387,8 +5217,11 @@ void IGFD::FileDialog::m_DrawFileListView(ImVec2 vSize) {
 
             int column_id = 0;
             bool _rowHovered = false;
+            int displayStart = (int)fdi.GetFilteredListSize(), displayEnd = 0;
             m_FileListClipper.Begin((int)fdi.GetFilteredListSize(), ImGui::GetTextLineHeightWithSpacing());
             while (m_FileListClipper.Step()) {
+                displayStart = ImMin(displayStart, m_FileListClipper.DisplayStart);
+                displayEnd   = ImMax(displayEnd, m_FileListClipper.DisplayEnd);
                 for (int i = m_FileListClipper.DisplayStart; i < m_FileListClipper.DisplayEnd; i++) {
                     if (i < 0) {
                         continue;
@@ -4399,6 +5232,8 @@ void IGFD::FileDialog::m_DrawFileListView(ImVec2 vSize) {
                         continue;
                     }
 
+                    fdi.RequestFileMetadata(pInfos, true);
+
                     m_BeginFileColorIconStyle(pInfos, _showColor, _str, &_font);
 
                     const bool selected = fdi.IsFileNameSelected(pInfos->fileNameExt);  // found
@@ -4440,6 +5275,7 @@ void IGFD::FileDialog::m_DrawFileListView(ImVec2 vSize) {
                 }
             }
             m_FileListClipper.End();
+            fdi.PrefetchFilteredRowsMetadata(displayStart, displayEnd);
         }
 
 #ifdef USE_EXPLORATION_BY_KEYS
@@ -4584,14 +5420,19 @@ void IGFD::FileDialog::m_DrawThumbnailsListView(ImVec2 vSize) {
             const float itemHeight = ImMax(g.FontSize, DisplayMode_ThumbailsList_ImageHeight) + g.Style.ItemSpacing.y;
 
             int column_id = 0;
+            int displayStart = (int)fdi.GetFilteredListSize(), displayEnd = 0;
             m_FileListClipper.Begin((int)fdi.GetFilteredListSize(), itemHeight);
             while (m_FileListClipper.Step()) {
+                displayStart = ImMin(displayStart, m_FileListClipper.DisplayStart);
+                displayEnd   = ImMax(displayEnd, m_FileListClipper.DisplayEnd);
                 for (int i = m_FileListClipper.DisplayStart; i < m_FileListClipper.DisplayEnd; i++) {
                     if (i < 0) continue;
 
                     auto pInfos = fdi.GetFilteredFileAt((size_t)i);
                     if (!pInfos.use_count()) continue;
 
+                    fdi.RequestFileMetadata(pInfos, true);
+
                     m_BeginFileColorIconStyle(pInfos, _showColor, _str, &_font);
 
                     bool selected = fdi.IsFileNameSelected(pInfos->fileNameExt);  // found
@@ -4631,9 +5472,7 @@ void IGFD::FileDialog::m_DrawThumbnailsListView(ImVec2 vSize) {
                     if (ImGui::TableNextColumn()) {  // file thumbnails
                         auto th = &pInfos->thumbnailInfo;
 
-                        if (!th->isLoadingOrLoaded) {
-                            m_AddThumbnailToLoad(pInfos);
-                        }
+                        m_AddThumbnailToLoad(pInfos);
                         if (th->isReadyToDisplay && th->textureID) {
                             ImGui::Image((ImTextureID)th->textureID, ImVec2((float)th->textureWidth, (float)th->textureHeight));
                         }
@@ -4644,6 +5483,7 @@ void IGFD::FileDialog::m_DrawThumbnailsListView(ImVec2 vSize) {
                 }
             }
             m_FileListClipper.End();
+            fdi.PrefetchFilteredRowsMetadata(displayStart, displayEnd);
         }
 
 #ifdef USE_EXPLORATION_BY_KEYS
@@ -203,9 +203,11 @@ struct IGFD_Thumbnail_Info {
 #include <set>
 #include <map>
 #include <list>
+#include <deque>
 #include <regex>
 #include <array>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <thread>
 #include <cfloat>
@@ -249,6 +251,34 @@ struct IGFD_Thumbnail_Info {
 #define EXT_MAX_LEVEL 10U
 #endif  // EXT_MAX_LEVEL
 
+#ifndef SCAN_BATCH_SIZE
+#define SCAN_BATCH_SIZE 256U  // entries the scan thread hands over at once
+#endif  // SCAN_BATCH_SIZE
+
+#ifndef SCAN_ENTRIES_PER_FRAME
+#define SCAN_ENTRIES_PER_FRAME 4096U  // max scanned entries added to the file list per frame
+#endif  // SCAN_ENTRIES_PER_FRAME
+
+#ifndef METADATA_WORKERS_COUNT
+#define METADATA_WORKERS_COUNT 4U  // threads reading the date and size of the files, stat is mostly latency on network shares
+#endif  // METADATA_WORKERS_COUNT
+
+#ifndef METADATA_PREFETCH_ROWS
+#define METADATA_PREFETCH_ROWS 64  // rows before and after the displayed ones whose date and size are read in background
+#endif  // METADATA_PREFETCH_ROWS
+
+#ifndef DIRECTORY_CACHE_MAX
+#define DIRECTORY_CACHE_MAX 16U  // max directory listings kept in memory, the least recently used is removed first
+#endif  // DIRECTORY_CACHE_MAX
+
+#ifndef SORT_PARALLEL_MIN_COUNT
+#define SORT_PARALLEL_MIN_COUNT 16384U  // under this count of files, the sort is done on the calling thread only
+#endif  // SORT_PARALLEL_MIN_COUNT
+
+#ifndef SORT_THREADS_MAX
+#define SORT_THREADS_MAX 8U  // max threads used for sorting a big file list
+#endif  // SORT_THREADS_MAX
+
 namespace IGFD {
 
 template <typename T>
@@ -366,7 +396,7 @@ public:
 
 class IGFD_API SearchManager {
 public:
-    std::string searchTag;
+    std::string searchTag;  // lower case, compared to FileInfos::fileNameExt_optimized
     char searchBuffer[MAX_FILE_DIALOG_NAME_BUFFER] = "";
     bool searchInputIsActive                       = false;
 
@@ -408,8 +438,14 @@ private:
     std::unordered_map<IGFD_FileStyleFlags, std::unordered_map<std::string, std::shared_ptr<FileStyle> > > m_FilesStyle;  // file infos for file
                                                                                                                           // extention only
     std::vector<FileStyle::FileStyleFunctor> m_FilesStyleFunctors;                                                        // file style via lambda function
+    std::unordered_map<std::string, std::regex> m_FilesStyleRegexes;                                                      // compiled regex criteria of m_FilesStyle
+    mutable std::unordered_map<std::string, std::shared_ptr<FileStyle> > m_FilesStyleCache;                               // resolved style by file type and name
     FilterInfos m_SelectedFilter;
 
+private:
+    bool m_SearchStyleRegex(const std::string& vCriteria, const std::string& vText) const;  // false if the criteria is not a regex
+    void m_AddStyleCriteria(const std::string& vCriteria);                                  // compile the criteria if its a regex, and reset the cache
+
 public:
     std::string dLGFilters;
     std::string dLGdefaultExt;
@@ -493,10 +529,15 @@ public:
     size_t fileSize       = 0U;                                       // for sorting operations
     std::pair<std::string, std::string> formatedFileSize;             // file size formated (10 o, 10 ko, 10 mo, 10 go)
     std::string fileModifDate;                                        // file user defined format of the date (data + time by default)
+    int64_t fileModifTime = 0;                                        // modification time in seconds since epoch, for sorting (0 if unknown)
     std::shared_ptr<FileStyle> fileStyle = nullptr;                   // style of the file
+    enum class MetadataStatus { NONE = 0, PREFETCH, DISPLAYED, RESOLVED };
+    MetadataStatus metadataStatus = MetadataStatus::NONE;             // fileSize and fileModifDate are valid when RESOLVED, see FileManager::RequestFileMetadata
 #ifdef USE_THUMBNAILS
-    IGFD_Thumbnail_Info thumbnailInfo;  // structre for the display for image file tetxure
-#endif                                  // USE_THUMBNAILS
+    IGFD_Thumbnail_Info thumbnailInfo;     // structre for the display for image file tetxure
+    uint32_t thumbnailRequestFrame = 0U;  // last frame where the row was displayed, a queued thumbnail not displayed is cancelled
+    bool thumbnailReleased = false;       // left the file list and the cache (main thread only), a thumbnail loaded after that is dropped
+#endif                                     // USE_THUMBNAILS
 
 public:
     bool SearchForTag(const std::string& vTag) const;  // will search a tag in fileNameExt and fileNameExt_optimized
@@ -524,12 +565,35 @@ public:
     virtual IGFD::Utils::PathStruct ParsePathFileName(const std::string& vPathFileName) = 0;
     // will return a list of files inside a path
     virtual std::vector<IGFD::FileInfos> ScanDirectory(const std::string& vPath) = 0;
+    // will report the files inside a path by batches, as they are read. called from the scan thread
+    // the scan stop as soon as vBatchFun return false. by default, report the whole ScanDirectory result at once
+    virtual void ScanDirectoryByBatches(const std::string& vPath, const std::function<bool(std::vector<IGFD::FileInfos>&)>& vBatchFun) {
+        auto files = ScanDirectory(vPath);
+        vBatchFun(files);
+    }
     // say if the path is well a directory
     virtual bool IsDirectory(const std::string& vFilePathName) = 0;
     // return a device list (<path, device name>) on windows, but can be used on other platforms for give to the user a list of devices paths.
     virtual std::vector<IGFD::PathDisplayedName> GetDevicesList() = 0;
     // return via argument the date and the size of a file (for solve issue regarding apis and widechars)
     virtual void GetFileDateAndSize(const std::string& vFilePathName, const IGFD::FileType& vFileType, std::string& voDate, size_t& voSize) = 0;
+    // same as GetFileDateAndSize, with the modification time in seconds since epoch, used for sorting by date
+    // by default the time is 0, and the dates are sorted as text
+    virtual void GetFileDateSizeAndTime(const std::string& vFilePathName, const IGFD::FileType& vFileType, std::string& voDate, size_t& voSize, int64_t& voTime) {
+        GetFileDateAndSize(vFilePathName, vFileType, voDate, voSize);
+        voTime = 0;
+    }
+    // start to report the changes in a directory by GetChangedDirectories, return false if not supported
+    // the listing of a directory is kept in memory only while the directory is watched
+    virtual bool WatchDirectory(const std::string& /*vPath*/) {
+        return false;
+    }
+    // stop to report the changes in a directory
+    virtual void UnwatchDirectory(const std::string& /*vPath*/) {
+    }
+    // return the watched directories whose content changed since the last call
+    virtual void GetChangedDirectories(std::vector<std::string>& /*voPaths*/) {
+    }
 };
 
 class IGFD_API FileManager {
@@ -558,6 +622,68 @@ private:
     std::string m_FileSystemName;
     std::unique_ptr<IFileSystem> m_FileSystemPtr = nullptr;
 
+    struct ScanState {                                   // directory listing running in a thread, see ScanDir
+        std::thread thread;                              // the scan thread
+        std::mutex batchesMutex;                         // protect batches
+        std::list<std::vector<FileInfos> > batches;      // scanned entries not yet added to m_FileList
+        std::atomic<bool> cancel{false};                 // ask the scan thread to stop
+        std::atomic<bool> done{false};                   // the scan thread pushed its last batch
+        std::atomic<size_t> countEntries{0U};            // entries scanned so far
+        bool finished = false;                           // all batches were added to m_FileList
+    };
+    std::unique_ptr<ScanState> m_ScanState = nullptr;
+
+    struct FileMetadata {  // date and size read by a metadata worker
+        std::shared_ptr<FileInfos> infos;
+        std::string date;
+        size_t size  = 0U;
+        int64_t time = 0;
+    };
+    struct MetadataState {                                   // date and size of the files, read in threads, see RequestFileMetadata
+        std::vector<std::thread> workers;                    // the metadata threads
+        std::mutex mutex;                                    // protect all the members below
+        std::condition_variable cv;                          // wake up the workers when a request is added
+        std::deque<std::shared_ptr<FileInfos> > displayed;   // rows displayed, the last displayed first
+        std::deque<std::shared_ptr<FileInfos> > background;  // prefetched rows and bulk requests, in request order
+        std::vector<FileMetadata> done;                      // resolved but not yet applied by UpdateMetadata
+        uint32_t generation = 0U;                            // increased when the file list is cleared, late results are dropped
+        bool stop           = false;                         // ask the workers to stop
+    };
+    std::unique_ptr<MetadataState> m_MetadataState = nullptr;
+    size_t m_CountMetadataPending = 0U;  // files requested and not yet resolved
+    size_t m_CountMetadataBulk    = 0U;  // files requested by a sort on size or date, the list is sorted again when all are resolved
+
+    struct SortKey {                        // sort keys of a file, filled once for the whole list, see m_SortFields
+        std::shared_ptr<FileInfos> infos;   // the file
+        const std::string* name = nullptr;  // fileNameExt_optimized (lower case)
+        const std::string* ext  = nullptr;  // fileExtLevels_optimized[0] (lower case)
+        const std::string* date = nullptr;  // fileModifDate, compared when the times are equal
+        FileType type;                      // directories first
+        size_t size  = 0U;                  // fileSize
+        int64_t time = 0;                   // fileModifTime
+    };
+    std::vector<SortKey> m_SortKeys;                                                     // keys of m_FileList, in the order of the list when they was filled
+    std::map<std::pair<SortingFieldEnum, bool>, std::vector<uint32_t> > m_SortOrders;  // indices in m_SortKeys by field and ascending direction
+    bool m_SortKeysMetadataDirty = false;                                                // sizes and times were resolved since the keys was filled
+
+    struct CachedDirectory {                                                            // listing of a watched directory, see ScanDir
+        std::string signature;                                                          // filters and flags the listing was made with
+        std::vector<std::shared_ptr<FileInfos> > files;                                 // the file list, with metadatas and thumbnails
+        std::vector<SortKey> sortKeys;                                                  // m_SortKeys of the list
+        std::map<std::pair<SortingFieldEnum, bool>, std::vector<uint32_t> > sortOrders;  // m_SortOrders of the list
+        bool sortKeysMetadataDirty = false;                                             // m_SortKeysMetadataDirty of the list
+        uint64_t lastUse           = 0U;                                                // for removing the least recently used
+    };
+    std::map<std::string, CachedDirectory> m_DirectoryCache;  // by path, the displayed directory is not in it
+    uint64_t m_DirectoryCacheUseCounter = 0U;
+    std::string m_FileListPath;       // directory of m_FileList when scanned by ScanDir, empty otherwise
+    std::string m_FileListSignature;  // filters and flags m_FileList was made with
+    bool m_FileListWatched = false;   // the directory of m_FileList is watched, so the list can be cached
+    bool m_FileListChanged = false;   // the directory of m_FileList changed since the scan, so the list will not be cached
+#ifdef USE_THUMBNAILS
+    std::vector<std::shared_ptr<FileInfos> > m_ReleasedFiles;  // files who left the file list and the cache, with a thumbnail to destroy
+#endif  // USE_THUMBNAILS
+
 public:
     bool inputPathActivated                               = false;  // show input for path edition
     bool devicesClicked                                   = false;  // event when a drive button is clicked
@@ -592,8 +718,7 @@ private:
     void m_CompleteFileInfos(const std::shared_ptr<FileInfos>& vInfos);                    // set time and date infos of a file (detail view mode)
     void m_RemoveFileNameInSelection(const std::string& vFileName);                               // selection : remove a file name
     void m_AddFileNameInSelection(const std::string& vFileName, bool vSetLastSelectionFileName);  // selection : add a file name
-    void m_AddFile(const FileDialogInternal& vFileDialogInternal, const std::string& vPath, const std::string& vFileName,
-                   const FileType& vFileType);  // add file called by scandir
+    void m_AddFile(const FileDialogInternal& vFileDialogInternal, const FileInfos& vScannedFile);  // add file called by scandir, date and size are already filled
     void m_AddPath(const FileDialogInternal& vFileDialogInternal, const std::string& vPath, const std::string& vFileName,
                    const FileType& vFileType);  // add file called by scandir
     void m_ScanDirForPathSelection(const FileDialogInternal& vFileDialogInternal,
@@ -602,15 +727,32 @@ private:
                          std::vector<std::string>::iterator vPathIter);   // open the popup list of paths
     void m_SetCurrentPath(std::vector<std::string>::iterator vPathIter);  // set the current path, update the path bar
     void m_ApplyFilteringOnFileList(const FileDialogInternal& vFileDialogInternal, std::vector<std::shared_ptr<FileInfos> >& vFileInfosList, std::vector<std::shared_ptr<FileInfos> >& vFileInfosFilteredList);
+    bool m_IsShownByFiltering(const FileDialogInternal& vFileDialogInternal, const std::shared_ptr<FileInfos>& vInfos) const;  // search tag and directory mode
+    void m_StopScan();                                                                                                          // cancel and join the scan thread
+    void m_StartMetadataWorkers();                                                                                              // start the metadata threads if not running
+    void m_StopMetadataWorkers();                                                                                               // stop and join the metadata threads
+    void m_ClearMetadataRequests();                                                                                             // drop the pending requests and the late results
+    void m_RequestAllMetadata();                                                                                                // request the files not yet resolved, for a sort on size or date
     static bool M_SortStrings(const FileDialogInternal& vFileDialogInternal,             //
                               const bool vInsensitiveCase, const bool vDescendingOrder,  //
                               const std::string& vA, const std::string& vB);
     void m_SortFields(const FileDialogInternal& vFileDialogInternal, std::vector<std::shared_ptr<FileInfos> >& vFileInfosList,
                       std::vector<std::shared_ptr<FileInfos> >& vFileInfosFilteredList);  // will sort a column
+    const std::vector<uint32_t>& m_GetFileListSortOrder(const FileDialogInternal& vFileDialogInternal, const bool vAscending);  // cached order of m_SortKeys for the sorting field
+    void m_ClearSortOrders();                                                                                                    // forget the keys and the cached orders of the file list
+    std::string m_GetFileListSignature(const FileDialogInternal& vFileDialogInternal) const;                                    // what a cached listing depend on, beside the directory
+    void m_StoreFileListInCache(const bool vComplete);                                                                           // keep the file list if its directory is watched, release it if not
+    bool m_LoadFileListFromCache(const FileDialogInternal& vFileDialogInternal, const std::string& vPath, const std::string& vSignature);
+    void m_RemoveCachedDirectory(std::map<std::string, CachedDirectory>::iterator vIter);  // unwatch the directory and release its files
+    void m_ReleaseFiles(const std::vector<std::shared_ptr<FileInfos> >& vFiles);            // the thumbnails of these files can be destroyed
+    static void M_FillSortKeys(const std::vector<std::shared_ptr<FileInfos> >& vFileInfosList, std::vector<SortKey>& voSortKeys);
+    static void M_ComputeSortOrder(const FileDialogInternal& vFileDialogInternal, const SortingFieldEnum vField,  //
+                                   const std::vector<SortKey>& vSortKeys, std::vector<uint32_t>& voOrder);   // ascending order, sorted in parallel for big lists
     bool m_CompleteFileInfosWithUserFileAttirbutes(const FileDialogInternal& vFileDialogInternal, const std::shared_ptr<FileInfos>& vInfos);
 
 public:
     FileManager();
+    ~FileManager();
     bool IsComposerEmpty() const;
     size_t GetComposerSize() const;
     bool IsFileListEmpty() const;
@@ -627,7 +769,7 @@ public:
     bool IsFileNameSelected(const std::string& vFileName);
     std::string GetBack();
     void ClearComposer();
-    void ClearFileLists();  // clear file list, will destroy thumbnail textures
+    void ClearFileLists();  // clear file list, the listing is kept in the directory cache when possible
     void ClearPathLists();  // clear path list, will destroy thumbnail textures
     void ClearAll();
     void ApplyFilteringOnFileList(const FileDialogInternal& vFileDialogInternal);
@@ -646,7 +788,21 @@ public:
     void SelectOrDeselectFileName(const FileDialogInternal& vFileDialogInternal, const std::shared_ptr<FileInfos>& vInfos);  // add/remove a filename in selection
     void SetCurrentDir(const std::string& vPath);                                                                            // define current directory for scan
     void ScanDir(const FileDialogInternal& vFileDialogInternal,
-                 const std::string& vPath);  // scan the directory for retrieve the file list
+                 const std::string& vPath);                          // start the scan thread who will retrieve the file list
+    void UpdateScan(const FileDialogInternal& vFileDialogInternal);  // add the entries scanned since the last frame, sort when the scan is over
+    bool IsScanRequested() const;                                    // a scan of the current path was started, over or not
+    bool IsScanning() const;                                         // the scan of the current path is not over
+    size_t GetScannedEntriesCount() const;                           // entries scanned so far
+    void UpdateDirectoryCache();                                     // forget the cached listings of the directories changed on disk
+#ifdef USE_THUMBNAILS
+    void TakeReleasedFiles(std::vector<std::shared_ptr<FileInfos> >& voFiles);  // get the files whose thumbnails can be destroyed
+#endif  // USE_THUMBNAILS
+    void RequestFileMetadata(const std::shared_ptr<FileInfos>& vInfos, bool vDisplayed);  // read date and size in background, displayed rows first
+    void PrefetchFilteredRowsMetadata(int vDisplayStart, int vDisplayEnd);                 // request the rows around the displayed ones
+    void UpdateMetadata(const FileDialogInternal& vFileDialogInternal);                    // apply the resolved date and size, sort again when a bulk request is over
+    bool IsReadingMetadata() const;                                                        // a bulk request for a sort on size or date is not over
+    size_t GetMetadataBulkCount() const;                                                   // files of the bulk request
+    size_t GetMetadataBulkResolvedCount() const;                                           // files of the bulk request already resolved
     std::string GetResultingPath();
     std::string GetResultingFileName(FileDialogInternal& vFileDialogInternal, IGFD_ResultMode vFlag);
     std::string GetResultingFilePathName(FileDialogInternal& vFileDialogInternal, IGFD_ResultMode vFlag);
@@ -734,17 +890,26 @@ protected:
 public:
     typedef std::function<void(IGFD_Thumbnail_Info*)> CreateThumbnailFun;   // texture 2d creation function binding
     typedef std::function<void(IGFD_Thumbnail_Info*)> DestroyThumbnailFun;  // texture 2d destroy function binding
+    typedef std::function<bool(const std::string&, IGFD_Thumbnail_Info*)> GenerateThumbnailFun;  // fill textureFileDatas (new[]) and size from a file path
 
 protected:
     enum class DisplayModeEnum { FILE_LIST = 0, THUMBNAILS_LIST, THUMBNAILS_GRID };
 
 private:
-    uint32_t m_CountFiles                                    = 0U;
-    bool m_IsWorking                                         = false;
-    std::shared_ptr<std::thread> m_ThumbnailGenerationThread = nullptr;
-    std::list<std::shared_ptr<FileInfos> > m_ThumbnailFileDatasToGet;  // base container
-    std::mutex m_ThumbnailFileDatasToGetMutex;
-    std::condition_variable m_ThumbnailFileDatasToGetCv;
+    struct ThumbnailQueue {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<FileInfos> > files;  // front : last requested, back : oldest requests, stolen by the others workers
+    };
+    std::atomic<uint32_t> m_CountFiles{0U};    // thumbnails done since the workers start
+    std::atomic<uint32_t> m_CountPending{0U};  // thumbnails queued or in work
+    std::atomic<int32_t> m_CountQueued{0};     // thumbnails waiting for a worker
+    std::atomic<bool> m_IsWorking{false};
+    std::vector<std::thread> m_ThumbnailWorkers;
+    std::vector<std::unique_ptr<ThumbnailQueue> > m_ThumbnailQueues;  // one per worker
+    std::mutex m_ThumbnailWorkersMutex;
+    std::condition_variable m_ThumbnailWorkersCv;
+    size_t m_NextThumbnailQueue = 0U;
+    uint32_t m_ThumbnailFrame   = 0U;
     std::list<std::shared_ptr<FileInfos> > m_ThumbnailToCreate;  // base container
     std::mutex m_ThumbnailToCreateMutex;
     std::list<IGFD_Thumbnail_Info> m_ThumbnailToDestroy;  // base container
@@ -752,20 +917,26 @@ private:
 
     CreateThumbnailFun m_CreateThumbnailFun   = nullptr;
     DestroyThumbnailFun m_DestroyThumbnailFun = nullptr;
+    std::vector<std::pair<std::string, GenerateThumbnailFun> > m_ThumbnailGenerators;  // coma separated exts, generator
 
 protected:
     DisplayModeEnum m_DisplayMode = DisplayModeEnum::FILE_LIST;
 
 private:
     void m_VariadicProgressBar(float fraction, const ImVec2& size_arg, const char* fmt, ...);
+    const GenerateThumbnailFun* m_GetThumbnailGenerator(const std::shared_ptr<FileInfos>& vFileInfos) const;  // user generator for this file ext, or nullptr
+    bool m_CanHaveThumbnail(const std::shared_ptr<FileInfos>& vFileInfos) const;
+    bool m_LoadImageThumbnail(const std::string& vFilePathName, IGFD_Thumbnail_Info* vThumbnailInfo);  // stb_image loading and resize
 
 protected:
     // will be call in cpu zone (imgui computations, will call a texture file retrieval thread)
-    void m_StartThumbnailFileDatasExtraction();                               // start the thread who will get byte buffer from image files
-    bool m_StopThumbnailFileDatasExtraction();                                // stop the thread who will get byte buffer from image files
-    void m_ThreadThumbnailFileDatasExtractionFunc();                          // the thread who will get byte buffer from image files
-    void m_DrawThumbnailGenerationProgress();                                 // a little progressbar who will display the texture gen status
-    void m_AddThumbnailToLoad(const std::shared_ptr<FileInfos>& vFileInfos);  // add texture to load in the thread
+    void m_StartThumbnailFileDatasExtraction();                                                      // start the workers who will get byte buffer from image files
+    bool m_StopThumbnailFileDatasExtraction();                                                       // stop the workers who will get byte buffer from image files
+    void m_ThreadThumbnailFileDatasExtractionFunc(size_t vWorkerIdx);                                // a worker who will get byte buffer from image files
+    bool m_PopThumbnailToLoad(size_t vWorkerIdx, std::shared_ptr<FileInfos>& vOutFileInfos);         // from its queue, or stolen from another
+    void m_CancelHiddenThumbnails();                                                                 // drop the queued thumbnails of the rows not displayed last frame
+    void m_DrawThumbnailGenerationProgress();                                                        // a little progressbar who will display the texture gen status
+    void m_AddThumbnailToLoad(const std::shared_ptr<FileInfos>& vFileInfos);                         // add texture to load by the workers, to call for each displayed row
     void m_AddThumbnailToCreate(const std::shared_ptr<FileInfos>& vFileInfos);
     void m_AddThumbnailToDestroy(const IGFD_Thumbnail_Info& vIGFD_Thumbnail_Info);
     void m_DrawDisplayModeToolBar();  // draw display mode toolbar (file list, thumbnails list, small thumbnails grid, big thumbnails grid)
@@ -774,6 +945,8 @@ protected:
 public:
     void SetCreateThumbnailCallback(const CreateThumbnailFun& vCreateThumbnailFun);
     void SetDestroyThumbnailCallback(const DestroyThumbnailFun& vCreateThumbnailFun);
+    // must be set before the first dialog display, called from the thumbnail thread
+    void AddThumbnailGenerator(const std::string& vComaSepExts, const GenerateThumbnailFun& vGenerateThumbnailFun);
 
     // must be call in gpu zone (rendering, possibly one rendering thread)
     void ManageGPUThumbnails();  // in gpu rendering zone, whill create or destroy texture
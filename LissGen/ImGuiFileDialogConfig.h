@@ -11,6 +11,9 @@
 // #define USE_CUSTOM_FILESYSTEM
 // this options need c++17
 // #define USE_STD_FILESYSTEM
+#ifdef _WIN32
+#define USE_STD_FILESYSTEM  // dirent.h for windows is not bundled
+#endif
 
 /////////////////////////////////
 //// MISC ///////////////////////
@@ -35,14 +38,21 @@
 //// THUMBNAILS /////////////////
 /////////////////////////////////
 
-// #define USE_THUMBNAILS
+#define USE_THUMBNAILS
+// this line disable stb_image, so only the files known by a generator set with AddThumbnailGenerator will have a thumbnail
+// (stb is not bundled here, the presets thumbnails come from the app)
+#define DONT_USE_STB_IMAGE
 // the thumbnail generation use the stb_image and stb_resize lib who need to define the implementation
 // btw if you already use them in your app, you can have compiler error due to "implemntation found in double"
 // so uncomment these line for prevent the creation of implementation of these libs again
 // #define DONT_DEFINE_AGAIN__STB_IMAGE_IMPLEMENTATION
 // #define DONT_DEFINE_AGAIN__STB_IMAGE_RESIZE_IMPLEMENTATION
 // #define IMGUI_RADIO_BUTTON RadioButton
-// #define DisplayMode_ThumbailsList_ImageHeight 32.0f
+#define DisplayMode_ThumbailsList_ImageHeight 48.0f
+// max count of thumbnail workers, bounded by the cpu core count
+// #define THUMBNAIL_WORKERS_MAX 8U
+// max count of thumbnails queued or in work, the others are asked again while their rows are displayed
+// #define THUMBNAIL_QUEUE_MAX 256U
 // #define tableHeaderFileThumbnailsString "Thumbnails"
 // #define DisplayMode_FilesList_ButtonString "FL"
 // #define DisplayMode_FilesList_ButtonHelp "File List"
@@ -3,27 +3,64 @@
 #include "imgui.h"
 #include "imgui_impl_sdl2.h"
 #include "imgui_impl_opengl3.h"
+#include "ImGuiFileDialog.h"
 #include <GL/gl3w.h>
 #include <vector>
+#include <array>
 #include <cmath>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <algorithm>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include <filesystem>
 
 #ifdef _WIN32
 #define _CRT_SECURE_NO_WARNINGS
 #include <windows.h>
-#include <commdlg.h>
-#pragma comment(lib, "Comdlg32.lib")
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
 #endif
 
 #define SAMPLE_RATE 44100
 #define FRAMES_PER_BUFFER 4096
 #define BUFFER_SIZE 4096
+#define TRAIL_RING_CAPACITY (1 << 17)
+#define TRAIL_LOD_LEVELS 12
+#define TRAIL_UPLOAD_CHUNK 65536
+#define TRAIL_LATENCY_HEADROOM 32768
+#define BLOCK_CLOCK_SIZE 64
+#define CAPTURE_PBO_COUNT 3
+#define CAPTURE_MAX_QUEUED 8
+#define RASTER_TILE 64
+#define LSJB_VERSION 1
+#define LSJB_SINGLE_WAVE 1u
+#define STREAM_WINDOW 64
+#define THUMBNAIL_SAMPLES 4096
+#define HOT_RELOAD_DEBOUNCE_MS 300
+#define HOT_RELOAD_WAIT_MS 100
+#define PLAYLIST_VISIBLE_ROWS 12
 #define PI 3.14159265358979323846
 
 const char* vertexShaderSource = R"(#version 330 core
@@ -33,8 +70,58 @@ const char* vertexShaderSource = R"(#version 330 core
 const char* fragmentShaderSource = R"(#version 330 core
     out vec4 FragColor; in vec4 vertexColor;
     void main() { FragColor = vertexColor; })";
+// One instance per trail segment: the two endpoints come from the same sample buffer offset by one sample,
+// and the four strip vertices expand it into a screen-space quad padded by the half width plus an AA fringe.
+const char* trailVertexShaderSource = R"(#version 330 core
+    layout (location = 0) in vec2 aStart; layout (location = 1) in vec2 aEnd;
+    out vec2 fragPos; flat out vec2 segA; flat out vec2 segB; out float progress;
+    uniform mat4 projection; uniform vec2 center; uniform float scale; uniform float lineWidth; uniform int segmentOffset; uniform int segmentCount;
+    void main() {
+        vec2 a = center + vec2(aStart.x, -aStart.y) * scale; vec2 b = center + vec2(aEnd.x, -aEnd.y) * scale;
+        vec2 dir = b - a; float len = length(dir); dir = len > 1e-4 ? dir / len : vec2(1.0, 0.0);
+        vec2 nrm = vec2(-dir.y, dir.x); float r = lineWidth * 0.5 + 1.0;
+        int cx = gl_VertexID & 1; int cy = gl_VertexID >> 1;
+        vec2 p = (cx == 0 ? a - dir * r : b + dir * r) + nrm * (cy == 0 ? -r : r);
+        gl_Position = projection * vec4(p, 0.0, 1.0);
+        fragPos = p; segA = a; segB = b;
+        progress = float(segmentOffset + gl_InstanceID + cx) / float(max(segmentCount, 1)); })";
+// Capsule distance gives round joins and caps; coverage falls off over one pixel for analytic AA.
+const char* trailFragmentShaderSource = R"(#version 330 core
+    in vec2 fragPos; flat in vec2 segA; flat in vec2 segB; in float progress;
+    out vec4 FragColor; uniform float lineWidth; uniform vec4 lineColor;
+    void main() {
+        vec2 pa = fragPos - segA; vec2 ba = segB - segA;
+        float h = clamp(dot(pa, ba) / max(dot(ba, ba), 1e-6), 0.0, 1.0);
+        float coverage = clamp(lineWidth * 0.5 - length(pa - ba * h) + 0.5, 0.0, 1.0);
+        float t = clamp(progress, 0.0, 1.0); float alpha = lineColor.a * coverage * t * t;
+        FragColor = vec4(lineColor.rgb * alpha, alpha); })";
+const char* markerVertexShaderSource = R"(#version 330 core
+    layout (location = 0) in vec2 aStart; uniform mat4 projection; uniform vec2 center; uniform float scale; uniform float pointSize;
+    void main() { gl_Position = projection * vec4(center.x + aStart.x * scale, center.y - aStart.y * scale, 0.0, 1.0); gl_PointSize = pointSize; })";
+const char* markerFragmentShaderSource = R"(#version 330 core
+    out vec4 FragColor; uniform vec4 color; void main() { FragColor = color; })";
+const char* heatSplatVertexShaderSource = R"(#version 330 core
+    layout (location = 0) in vec2 aSample; uniform float gain;
+    void main() { gl_Position = vec4(aSample * gain, 0.0, 1.0); gl_PointSize = 1.0; })";
+const char* heatSplatFragmentShaderSource = R"(#version 330 core
+    out vec4 FragColor; void main() { FragColor = vec4(1.0); })";
+const char* fullscreenVertexShaderSource = R"(#version 330 core
+    out vec2 uv;
+    void main() { vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2); uv = p; gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0); })";
+const char* heatDisplayFragmentShaderSource = R"(#version 330 core
+    in vec2 uv; out vec4 FragColor; uniform sampler2D heat; uniform sampler1D lut; uniform int toneMap; uniform float fullScale; uniform float gamma;
+    void main() {
+        float v = texture(heat, uv).r;
+        float t = toneMap == 0 ? log(1.0 + v) / log(1.0 + fullScale) : pow(clamp(v / fullScale, 0.0, 1.0), 1.0 / gamma);
+        t = clamp(t, 0.0, 1.0); FragColor = vec4(texture(lut, t).rgb, t); })";
 
 enum WaveType { SINE, SQUARE, SAWTOOTH };
+enum ScaleMode { SCALE_FIXED, SCALE_SLIDING_MAX, SCALE_SMOOTHED_PEAK };
+enum RenderMode { RENDER_TRAIL, RENDER_HEATMAP };
+enum DecimationMethod { DECIMATE_DROP, DECIMATE_AVERAGE, DECIMATE_MINMAX };
+enum CaptureFormat { CAPTURE_PNG, CAPTURE_RAW };
+enum ToneMap { TONEMAP_LOG, TONEMAP_GAMMA };
+enum WatchTarget { WATCH_WAVE, WATCH_PLAYLIST, WATCH_COUNT };
 
 struct FrequencyRow {
     float freq;
@@ -54,23 +141,473 @@ struct PlaylistItem {
     float duration = 5.0f;
 };
 
+// First error found by the wave text parser; `message` is a static string, so a failed parse allocates nothing.
+struct ParseError {
+    int line = 0, column = 0;
+    const char* message = nullptr;
+};
+
+// Growable text buffer reused across serializations; clear() keeps the capacity, so steady-state formatting
+// allocates nothing. Floats are written with to_chars in their shortest round-trip form.
+struct TextWriter {
+    std::vector<char> data;
+    size_t size = 0;
+    void clear() { size = 0; }
+    char* reserve(size_t n) { if (size + n > data.size()) data.resize((std::max)(data.size() * 2, size + n)); return data.data() + size; }
+    void put(char c) { *reserve(1) = c; size++; }
+    void put(std::string_view s) { std::memcpy(reserve(s.size()), s.data(), s.size()); size += s.size(); }
+    template <typename T> void putNumber(T value) { char* p = reserve(32); size = std::to_chars(p, p + 32, value).ptr - data.data(); }
+    // Phases are only written for stored presets; the live channels' phases are just wherever playback is.
+    void putRow(const FrequencyRow& row, bool withPhase = false) {
+        put(row.type == SQUARE ? 'Q' : row.type == SAWTOOTH ? 'W' : 'S'); putNumber(row.freq);
+        if (withPhase && row.phase != 0.0) { put('@'); putNumber(row.phase); }
+        if (row.muted) put("(M)");
+    }
+    void putRows(const std::vector<FrequencyRow>& rows, bool withPhase = false) { for (size_t i = 0; i < rows.size(); i++) { if (i) put(','); putRow(rows[i], withPhase); } }
+    std::string_view view() const { return std::string_view(data.data(), size); }
+};
+
+// Backing store of the wave text box, grown through ImGui's resize callback. Each row's token records where it
+// sits in `text` and what it was formatted from, so editing a few rows only splices those tokens back in.
+struct WaveTextEditor {
+    struct Token { size_t offset, length; float freq; WaveType type; bool muted; };
+    std::string text;
+    std::vector<Token> tokensL, tokensR;
+    bool indexValid = false;
+};
+
+// Single-pass scanner over wave and playlist text. Rows are appended to caller-owned vectors, so repeated
+// parses reuse their capacity, and numbers go through from_chars without building temporary strings.
+struct WaveScanner {
+    std::string_view text;
+    size_t pos = 0, lineStart = 0;
+    int line = 1;
+    ParseError error;
+    WaveScanner(std::string_view t) : text(t) {}
+    bool atEnd() const { return pos >= text.size(); }
+    char peek() const { return pos < text.size() ? text[pos] : '\0'; }
+    bool startsWith(std::string_view word) const { return text.compare(pos, word.size(), word) == 0; }
+    void advance() { if (text[pos] == '\n') { line++; lineStart = pos + 1; } pos++; }
+    void skipSpace(bool newlines) { while (!atEnd() && (peek() == ' ' || peek() == '\t' || peek() == '\r' || (newlines && peek() == '\n'))) advance(); }
+    void skipLine() { while (!atEnd() && peek() != '\n') pos++; if (!atEnd()) advance(); }
+    bool fail(const char* message) { if (!error.message) error = { line, (int)(pos - lineStart) + 1, message }; return false; }
+    template <typename T> bool parseNumber(T& value) {
+        auto result = std::from_chars(text.data() + pos, text.data() + text.size(), value);
+        if (result.ec != std::errc()) return fail("expected a number");
+        if (!std::isfinite(value)) return fail("number must be finite");
+        pos = result.ptr - text.data(); return true;
+    }
+    // [S|Q|W]<frequency>[@<initial phase>][(M)]
+    bool parseRow(std::vector<FrequencyRow>& rows) {
+        WaveType type = SINE; char c = (char)toupper((unsigned char)peek());
+        if (c == 'Q') { type = SQUARE; pos++; } else if (c == 'W') { type = SAWTOOTH; pos++; } else if (c == 'S') pos++;
+        float freq; if (!parseNumber(freq)) return false;
+        FrequencyRow row(freq); row.type = type;
+        if (peek() == '@') { pos++; if (!parseNumber(row.phase)) return false; }
+        skipSpace(false);
+        if (startsWith("(M)")) { row.muted = true; pos += 3; }
+        rows.push_back(row); return true;
+    }
+    // Comma-separated rows up to `terminator`, which is left unconsumed; '\n' also ends at end of text. Empty entries are skipped.
+    bool parseRowList(std::vector<FrequencyRow>& rows, char terminator) {
+        bool multiline = terminator != '\n';
+        for (;;) {
+            skipSpace(multiline);
+            if (peek() == terminator) return true;
+            if (atEnd()) return multiline ? fail("missing closing '}'") : true;
+            if (peek() == ',') { pos++; continue; }
+            if (!parseRow(rows)) return false;
+            skipSpace(multiline);
+            if (peek() == ',') pos++;
+            else if (!atEnd() && peek() != terminator) return fail("expected ',' between rows");
+        }
+    }
+};
+
+struct TrailSpan {
+    const float* xy = nullptr;
+    size_t count = 0;
+    uint64_t end = 0;
+};
+
+// Lock-free single-producer ring of interleaved (x, y) samples. Every slot is written twice,
+// at i and i + capacity, so the latest N samples are always one contiguous span.
+struct TrailRing {
+    std::vector<float> xy;
+    size_t capacity;
+    std::atomic<uint64_t> head{ 0 };
+    TrailRing(size_t cap) : xy(cap * 4, 0.0f), capacity(cap) {}
+    void push(float x, float y) {
+        uint64_t h = head.load(std::memory_order_relaxed); size_t slot = (size_t)(h % capacity);
+        xy[slot * 2] = x; xy[slot * 2 + 1] = y; xy[(slot + capacity) * 2] = x; xy[(slot + capacity) * 2 + 1] = y;
+        head.store(h + 1, std::memory_order_release);
+    }
+    TrailSpan latest(size_t n) const { return ending(head.load(std::memory_order_acquire), n); }
+    TrailSpan ending(uint64_t end, size_t n) const {
+        n = (size_t)(std::min)((uint64_t)(std::min)(n, capacity), end);
+        size_t start = (size_t)((end - n) % capacity);
+        return { xy.data() + start * 2, n, end };
+    }
+};
+
+// Trail index of the first point of each recent audio block and the DAC time that block will be heard at,
+// so the renderer can show what is audible now rather than what was just synthesized.
+struct BlockClock {
+    struct Stamp { std::atomic<uint64_t> index{ 0 }; std::atomic<double> dacTime{ 0.0 }; };
+    Stamp stamps[BLOCK_CLOCK_SIZE];
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<double> outputLatency{ 0.0 };
+    void push(uint64_t index, double dacTime, double latency) {
+        uint64_t n = count.load(std::memory_order_relaxed); Stamp& s = stamps[n % BLOCK_CLOCK_SIZE];
+        s.index.store(index, std::memory_order_relaxed); s.dacTime.store(dacTime, std::memory_order_relaxed);
+        outputLatency.store(latency, std::memory_order_relaxed);
+        count.store(n + 1, std::memory_order_release);
+    }
+    // Interpolates between the stamps around `time`, extrapolating at `pointRate` past the newest one.
+    // Returns false when the host does not report DAC times.
+    bool positionAt(double time, double pointRate, double& position) const {
+        uint64_t n = count.load(std::memory_order_acquire); if (n == 0) return false;
+        uint64_t oldest = n > BLOCK_CLOCK_SIZE - 1 ? n - (BLOCK_CLOCK_SIZE - 1) : 0;
+        bool hasNewer = false; double newerDac = 0.0; uint64_t newerIndex = 0, index = 0;
+        for (uint64_t i = n; i-- > oldest;) {
+            const Stamp& s = stamps[i % BLOCK_CLOCK_SIZE];
+            double dac = s.dacTime.load(std::memory_order_relaxed); index = s.index.load(std::memory_order_relaxed);
+            if (dac <= 0.0) return false;
+            if (dac <= time) {
+                if (!hasNewer) position = index + (time - dac) * pointRate;
+                else position = index + (double)(newerIndex - index) * (std::min)((time - dac) / (std::max)(newerDac - dac, 1e-9), 1.0);
+                return true;
+            }
+            hasNewer = true; newerDac = dac; newerIndex = index;
+        }
+        position = (double)index;
+        return true;
+    }
+};
+
+// Auto-scale tracker fed by the audio thread as trail samples arrive; the renderer only reads `level`.
+// The sliding maximum keeps a monotonic deque of (index, peak) in a fixed ring, so each push is amortized O(1).
+struct ScopeNormalizer {
+    std::atomic<int> mode{ SCALE_SLIDING_MAX };
+    std::atomic<float> fixedScale{ 1.0f }, attackMs{ 5.0f }, releaseMs{ 400.0f };
+    std::atomic<size_t> window{ BUFFER_SIZE };
+    std::atomic<float> level{ 0.001f };
+    std::vector<uint64_t> dequeIndex;
+    std::vector<float> dequeValue;
+    size_t dequeHead = 0, dequeSize = 0;
+    uint64_t count = 0;
+    float smoothed = 0.0f, attackCoef = 0.0f, releaseCoef = 0.0f, coefAttackMs = -1.0f, coefReleaseMs = -1.0f, coefRate = 0.0f;
+    ScopeNormalizer(size_t cap) : dequeIndex(cap), dequeValue(cap) {}
+    void push(float x, float y, float sampleRate) {
+        size_t cap = dequeIndex.size();
+        size_t w = (std::max)((size_t)1, (std::min)(window.load(std::memory_order_relaxed), cap));
+        float peak = (std::max)(std::abs(x), std::abs(y));
+        while (dequeSize > 0 && dequeIndex[dequeHead] + w <= count) { dequeHead = (dequeHead + 1) % cap; dequeSize--; }
+        while (dequeSize > 0 && dequeValue[(dequeHead + dequeSize - 1) % cap] <= peak) dequeSize--;
+        size_t back = (dequeHead + dequeSize) % cap; dequeIndex[back] = count; dequeValue[back] = peak; dequeSize++;
+        count++;
+        float aMs = attackMs.load(std::memory_order_relaxed), rMs = releaseMs.load(std::memory_order_relaxed);
+        if (aMs != coefAttackMs || rMs != coefReleaseMs || sampleRate != coefRate) {
+            attackCoef = std::exp(-1.0f / ((std::max)(aMs, 0.01f) * 0.001f * sampleRate));
+            releaseCoef = std::exp(-1.0f / ((std::max)(rMs, 0.01f) * 0.001f * sampleRate));
+            coefAttackMs = aMs; coefReleaseMs = rMs; coefRate = sampleRate;
+        }
+        smoothed = peak + (smoothed - peak) * (peak > smoothed ? attackCoef : releaseCoef);
+        float v = 0.0f;
+        switch (mode.load(std::memory_order_relaxed)) {
+        case SCALE_FIXED: v = fixedScale.load(std::memory_order_relaxed); break;
+        case SCALE_SLIDING_MAX: v = dequeValue[dequeHead]; break;
+        case SCALE_SMOOTHED_PEAK: v = smoothed; break;
+        }
+        level.store((std::max)(v, 0.001f), std::memory_order_relaxed);
+    }
+};
+
+// Reduces the full-rate signal to trail points in the audio thread, one bucket of `factor` samples at a time.
+// Min/max emits the two samples bounding whichever axis swung further in the bucket, in time order.
+struct TrailDecimator {
+    struct Point { float x, y; int index; };
+    std::atomic<int> factor{ 2 }, method{ DECIMATE_DROP };
+    int bucketFactor = 0, bucketMethod = -1, filled = 0;
+    bool fixedPairs = false;  // min/max always emits two points, as the trail LOD levels index by it; else a flat bucket emits one
+    float sumX = 0.0f, sumY = 0.0f;
+    Point first{}, minX{}, maxX{}, minY{}, maxY{};
+    float pointRate() const { int f = (std::max)(1, factor.load(std::memory_order_relaxed)); return (float)SAMPLE_RATE / f * (method.load(std::memory_order_relaxed) == DECIMATE_MINMAX ? 2.0f : 1.0f); }
+    int push(float x, float y, float* out) {
+        int f = (std::max)(1, factor.load(std::memory_order_relaxed)), m = method.load(std::memory_order_relaxed);
+        if (f != bucketFactor || m != bucketMethod) { bucketFactor = f; bucketMethod = m; filled = 0; }
+        Point p = { x, y, filled };
+        if (filled == 0) { sumX = sumY = 0.0f; first = minX = maxX = minY = maxY = p; }
+        sumX += x; sumY += y;
+        if (x < minX.x) minX = p;
+        if (x > maxX.x) maxX = p;
+        if (y < minY.y) minY = p;
+        if (y > maxY.y) maxY = p;
+        if (++filled < f) return 0;
+        filled = 0;
+        switch (m) {
+        case DECIMATE_AVERAGE: out[0] = sumX / f; out[1] = sumY / f; return 1;
+        case DECIMATE_MINMAX: {
+            Point lo = minX, hi = maxX;
+            if (maxY.y - minY.y > maxX.x - minX.x) { lo = minY; hi = maxY; }
+            if (lo.index == hi.index && !fixedPairs) { out[0] = lo.x; out[1] = lo.y; return 1; }
+            if (lo.index > hi.index) std::swap(lo, hi);
+            out[0] = lo.x; out[1] = lo.y; out[2] = hi.x; out[3] = hi.y; return 2;
+        }
+        default: out[0] = first.x; out[1] = first.y; return 1;
+        }
+    }
+};
+
+// GPU-resident trail history. Level 0 holds every trail point in a ring of `length` points; each higher level
+// is the min/max envelope of the level below (two points out of every four), so a long visible span can be
+// drawn from a coarser level at roughly one point per pixel. Each buffer has one extra slot mirroring slot 0.
+struct TrailLevel {
+    GLuint vbo = 0;
+    size_t capacity = 0;
+    uint64_t head = 0;
+    TrailDecimator envelope;
+    std::vector<float> staging;
+};
+
+struct TrailStore {
+    TrailLevel levels[TRAIL_LOD_LEVELS];
+    size_t length = 0;
+    uint64_t consumed = 0;
+};
+
+struct ScopeGL {
+    GLuint shaderProgram = 0, vao = 0, vbo = 0;
+    GLuint trailProgram = 0, trailVao = 0, markerProgram = 0;
+    TrailStore store;
+    GLuint heatSplatProgram = 0, heatDecayProgram = 0, heatDisplayProgram = 0, heatVao = 0, heatVbo = 0, fullscreenVao = 0;
+    GLuint heatFbo = 0, heatTex = 0, lutTex = 0;
+    int heatSize = 0;
+    uint64_t heatHead = 0;
+};
+
+// Fixed set of threads draining a FIFO of jobs. The destructor finishes queued jobs before joining.
+struct WorkerPool {
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable cv, idle;
+    std::atomic<int> pending{ 0 };
+    bool stopping = false;
+    WorkerPool(unsigned count) { for (unsigned i = 0; i < (std::max)(count, 1u); i++) threads.emplace_back([this] { run(); }); }
+    ~WorkerPool() { { std::lock_guard<std::mutex> lock(mutex); stopping = true; } cv.notify_all(); for (auto& t : threads) t.join(); }
+    void submit(std::function<void()> job) { pending++; { std::lock_guard<std::mutex> lock(mutex); jobs.push_back(std::move(job)); } cv.notify_one(); }
+    void wait(int limit = 0) { std::unique_lock<std::mutex> lock(mutex); idle.wait(lock, [&] { return pending.load() <= limit; }); }
+    void run() {
+        for (;;) {
+            std::function<void()> job;
+            { std::unique_lock<std::mutex> lock(mutex); cv.wait(lock, [this] { return stopping || !jobs.empty(); }); if (jobs.empty()) return; job = std::move(jobs.front()); jobs.pop_front(); }
+            job();
+            { std::lock_guard<std::mutex> lock(mutex); pending--; } idle.notify_all();
+        }
+    }
+};
+
+// Scope readback through a ring of pixel-pack buffers: a frame is mapped only once its fence has passed,
+// a few frames after glReadPixels was queued, and encoding happens on the worker pool.
+struct CaptureSlot {
+    GLuint pbo = 0;
+    GLsync fence = nullptr;
+    int width = 0, height = 0, format = CAPTURE_PNG;
+    std::string path;
+};
+
+struct FrameCapture {
+    CaptureSlot slots[CAPTURE_PBO_COUNT];
+    int writeSlot = 0, pendingSlots = 0, sequenceFrame = 0, framesDropped = 0, screenshotCount = 0;
+    long long sessionId = 0;
+    std::atomic<int> framesWritten{ 0 }, framesFailed{ 0 };
+    std::mutex bufferMutex;
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    WorkerPool encoders{ (std::max)(2u, std::thread::hardware_concurrency() / 2) };
+};
+
+// Software counterpart of drawLissajousGL for headless export. Segments are binned into square tiles and each
+// tile row is shaded on its own worker with the same capsule coverage, MAX blend and fade as the trail shader.
+struct ScopeRaster {
+    int width = 0, height = 0;
+    float margin = 20.0f;
+    std::vector<float> graticule, points;
+    std::vector<std::vector<uint32_t>> bins;
+};
+
+// Preset previews for the file dialog, drawn by the CPU rasterizer on the dialog's thumbnail workers, one preview per
+// worker at a time. Each one is kept under `dir` with its path, mtime and size as key, so a folder seen before gets its
+// previews without parsing.
+struct ThumbnailCache {
+    std::string dir;
+};
+
+// .lsjb: native little-endian binary presets. The header points at an item index and at one packed array per
+// oscillator field; each item owns `countL + countR` consecutive rows starting at `firstRow`, left channel first.
+struct LsjbHeader {
+    char magic[4];
+    uint32_t version, itemCount, flags;
+    uint64_t rowCount, indexOffset, phaseOffset, freqOffset, typeOffset, muteOffset;
+};
+
+struct LsjbItem {
+    uint64_t firstRow;
+    uint32_t countL, countR;
+    float duration;
+    uint32_t reserved;
+};
+
+// Read-only view of a whole file: mmap on POSIX, a file mapping on Windows.
+struct MappedFile {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE, mapping = NULL;
+    bool open(const std::string& path) {
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER length; if (!GetFileSizeEx(file, &length) || length.QuadPart == 0) return false;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL); if (!mapping) return false;
+        data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0); size = (size_t)length.QuadPart;
+        return data != nullptr;
+    }
+    ~MappedFile() { if (data) UnmapViewOfFile(data); if (mapping) CloseHandle(mapping); if (file != INVALID_HANDLE_VALUE) CloseHandle(file); }
+#else
+    int fd = -1;
+    bool open(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDONLY); if (fd < 0) return false;
+        struct stat info; if (fstat(fd, &info) != 0 || info.st_size == 0) return false;
+        void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0); if (view == MAP_FAILED) return false;
+        data = (const unsigned char*)view; size = (size_t)info.st_size;
+        return true;
+    }
+    ~MappedFile() { if (data) munmap((void*)data, size); if (fd >= 0) close(fd); }
+#endif
+};
+
+struct AudioState;
+
+// Playlist played straight from a mapped .lsjp/.lsjb file. For text, an indexer thread records where each ITEM
+// starts; a prefetch thread keeps the STREAM_WINDOW items from the play head onwards decoded, and drops the rest.
+struct StreamingPlaylist {
+    MappedFile file;
+    std::string path, error;
+    bool binary = false, indexDone = false, stopping = false;
+    LsjbHeader header = {};
+    std::vector<uint64_t> offsets;
+    std::map<size_t, PlaylistItem> window;
+    size_t playHead = 0;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread indexer, prefetcher;
+    ~StreamingPlaylist() {
+        { std::lock_guard<std::mutex> lock(mutex); stopping = true; } cv.notify_all();
+        if (indexer.joinable()) indexer.join();
+        if (prefetcher.joinable()) prefetcher.join();
+    }
+    // Items whose extent is known; the last text item is only complete once the next ITEM or the end is found.
+    size_t available() const { return binary ? header.itemCount : indexDone ? offsets.size() : (offsets.empty() ? 0 : offsets.size() - 1); }
+    bool take(size_t index, PlaylistItem& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        playHead = index; cv.notify_all();
+        auto it = window.find(index); if (it == window.end()) return false;
+        item = std::move(it->second); window.erase(it); return true;
+    }
+};
+
+// Runs file dialogs, reads, parses, formats and writes one job at a time off the render thread. Results come back
+// as completions that the UI thread applies at the start of its next frame.
+struct IoWorker {
+    WorkerPool pool{ 1 };
+    std::atomic<bool> busy{ false };
+    std::atomic<float> progress{ 0.0f };
+    const char* status = "";
+    TextWriter writer;
+    std::mutex mutex;
+    std::vector<std::function<void(AudioState&)>> completions;
+};
+
+struct FileStamp {
+    std::filesystem::file_time_type time{};
+    uintmax_t size = 0;
+    bool exists = false;
+    bool operator!=(const FileStamp& other) const { return exists != other.exists || size != other.size || time != other.time; }
+};
+
+// Hot reload of the active wave and playlist files. The thread sleeps on change notifications for their folders
+// (inotify on Linux, FindFirstChangeNotification on Windows, a plain poll elsewhere) and marks a file changed when its
+// stamp moved; the UI reloads it once no change was seen for HOT_RELOAD_DEBOUNCE_MS, so a writer is never read midway.
+struct FileWatcher {
+    struct Target {
+        std::string path;     // requested by the UI
+        bool active = false;  // the file existed when requested; a missing placeholder name is not watched
+        FileStamp stamp;
+        Uint32 changedAt = 0; // SDL ticks of the last change seen, 0 when no reload is pending
+    };
+    Target targets[WATCH_COUNT];
+    unsigned generation = 0;
+    bool stopping = false;
+    std::mutex mutex;
+    std::thread thread;
+    ~FileWatcher() {
+        { std::lock_guard<std::mutex> lock(mutex); stopping = true; }
+        if (thread.joinable()) thread.join();
+    }
+};
+
+// Playlist editor state. `selected` runs parallel to AudioState::playlist and is resized to it every frame;
+// the label buffer is reused by every visible row.
+struct PlaylistView {
+    std::vector<char> selected;
+    int anchor = -1;          // last clicked row, start of a Shift+click range
+    int scrolledTo = -1;      // playing item the table last scrolled to
+    bool followPlaying = true;
+    float duration = 5.0f;    // value applied by "Set Duration"
+    char label[64] = {};
+};
+
 struct AudioState {
     std::vector<FrequencyRow> channelL, channelR;
-    std::vector<float> lissajousL, lissajousR;
-    std::mutex bufferMutex;
-    int trailPercent = 100, targetFPS = 240;
+    TrailRing trail{ TRAIL_RING_CAPACITY };
+    TrailRing rawRing{ SAMPLE_RATE };
+    ScopeNormalizer normalizer{ TRAIL_RING_CAPACITY };
+    TrailDecimator decimator;
+    std::mutex bankMutex;
+    WavePreset pendingBank;
+    bool pendingKeepsPhase = false;  // adoption carries the live phases over to rows at the same index
+    std::atomic<bool> bankReady{ false }, bankAdopted{ false };
+    int trailPercent = 100, targetFPS = 240, trailLength = BUFFER_SIZE;
+    float lineWidth = 2.0f;
+    int renderMode = RENDER_TRAIL, heatmapSize = 1024, heatToneMap = TONEMAP_LOG;
+    float heatPersistence = 1.0f, heatFullScale = 200.0f, heatGamma = 2.2f;
     bool running = false, shiftPressed = false, ctrlPressed = false;
     bool showStartEndPoints = false, audioMuted = false;
     std::vector<PlaylistItem> playlist;
+    std::unique_ptr<StreamingPlaylist> stream;
+    PlaylistView playlistView;
     int currentPlaylistItem = -1;
     float playlistTimer = 0.0f;
     bool playlistPlaying = false, loopPlaylist = true;
     std::string currentWaveFile = "Untitled.lsj";
     std::string currentPlaylistFile = "Untitled.lsjp";
-    char waveTextBuffer[2048] = { 0 };
+    WaveTextEditor waveEditor;
     std::string parseErrorMsg;
+    WavePreset parseBank;
+    TextWriter textWriter;
     bool waveDataIsDirty = true;
     bool showHelpWindow = false;
+    BlockClock blockClock;
+    bool syncToAudio = true;
+    double streamTime = 0.0;
+    float displayLagMs = 0.0f;
+    bool screenshotRequested = false, recording = false;
+    int captureFormat = CAPTURE_PNG;
+    char captureDir[260] = ".";
+    std::string presetDir = ".";
+    bool hotReload = false;
+    IoWorker io;
+    FileWatcher watcher;
 };
 
 struct DragPayload {
@@ -78,23 +615,80 @@ struct DragPayload {
     char sourceChannel;
 };
 
-void saveWaveToFile(const std::string& path, AudioState& state);
 void loadWaveFromFile(const std::string& path, AudioState& state);
-void savePlaylistToFile(const std::string& path, AudioState& state);
 void loadPlaylistFromFile(const std::string& path, AudioState& state);
+bool readWaveBank(const std::string& path, WavePreset& bank, std::string& error);
+bool readPlaylistItems(const std::string& path, std::vector<PlaylistItem>& items, std::string& error, std::atomic<float>* progress = nullptr);
+bool writeWaveBank(const std::string& path, const WavePreset& bank, TextWriter& out);
+bool writePlaylistItems(const std::string& path, const std::vector<PlaylistItem>& items, TextWriter& out, std::atomic<float>* progress = nullptr);
+void publishBank(AudioState& state, WavePreset&& bank, bool keepPhases = false);
+bool adoptPendingBank(AudioState& state);
+bool startIoJob(AudioState& state, const char* status, std::function<void()> work);
+void postIoCompletion(AudioState& state, std::function<void(AudioState&)> done);
+void applyIoCompletions(AudioState& state);
+void drawIoProgress(AudioState& state);
+void openPresetDialog(AudioState& state, const char* key, const char* title, const char* filters, const std::string& fileName);
+void drawFileDialogs(AudioState& state);
+void drawFrequencyRows(AudioState& state, std::vector<FrequencyRow>& rows, char channel);
+void drawPlaylistTable(AudioState& state);
+void reorderPlaylist(AudioState& state, const std::vector<int>& order, std::vector<char>&& selected);
+void loadWaveJob(AudioState& state, const std::string& path);
+void saveWaveJob(AudioState& state, const std::string& path, const WavePreset& bank);
+void loadPlaylistJob(AudioState& state, const std::string& path, bool reload = false);
+FileStamp readFileStamp(const std::string& path);
+void setWatchedFile(FileWatcher& watcher, int target, const std::string& path);
+void rememberFileStamp(FileWatcher& watcher, const std::string& path);
+void runFileWatcher(FileWatcher& watcher);
+void pollHotReload(AudioState& state);
+void savePlaylistJob(AudioState& state, const std::string& path, const std::vector<PlaylistItem>& items);
 void formatWaveToTextBuffer(AudioState& state);
+int waveTextResizeCallback(ImGuiInputTextCallbackData* data);
 bool parseTextBufferToWave(AudioState& state);
+bool parseWaveText(std::string_view text, WavePreset& bank, ParseError& error);
+bool parseWaveFile(std::string_view text, WavePreset& bank, ParseError& error);
+bool parsePlaylistFile(std::string_view text, std::vector<PlaylistItem>& items, ParseError& error, std::atomic<float>* progress = nullptr);
+bool readFileToString(const std::string& path, std::string& out);
+bool writeFileFromBuffer(const std::string& path, const TextWriter& writer);
+std::string formatParseError(const std::string& source, const ParseError& error);
 void loadPlaylistItem(AudioState& state, int index);
-GLuint createShaderProgram();
+GLuint createShaderProgram(const char* vsSource, const char* fsSource);
 float getStep(bool shift, bool ctrl);
 int audioCallback(const void* inputBuffer, void* outputBuffer, unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void* userData);
-void drawLissajousGL(AudioState& state, int x, int y, int width, int height, GLuint shaderProgram, GLuint vao, GLuint vbo);
-#ifdef _WIN32
-std::string openFileDialog(const char* filter, const char* defExt);
-std::string saveFileDialog(const char* filter, const char* defExt);
-#endif
+void drawLissajousGL(AudioState& state, int x, int y, int width, int height, ScopeGL& gl);
+void resizeTrailStoreGL(TrailStore& store, size_t length);
+void appendTrailLevelGL(TrailLevel& level, const float* xy, size_t count);
+void ingestTrailGL(AudioState& state, TrailStore& store);
+void initHeatmapGL(ScopeGL& gl);
+void captureScopeGL(AudioState& state, FrameCapture& capture, int x, int y, int width, int height);
+void finishCaptureGL(FrameCapture& capture, bool wait);
+bool writePngFile(const std::string& path, const unsigned char* rgba, int width, int height);
+bool writeRawFile(const std::string& path, const unsigned char* rgba, int width, int height);
+float synthesizeChannel(std::vector<FrequencyRow>& rows);
+void rasterizeScopeCPU(ScopeRaster& raster, WorkerPool* pool, const float* xy, size_t count, float maxVal, float lineWidth, bool markers, unsigned char* rgba);
+int runExportCommand(int argc, char* argv[]);
+int runConvertCommand(int argc, char* argv[]);
+bool hasExtension(const std::string& path, const char* extension);
+bool readPresetBinary(const std::string& path, std::vector<PlaylistItem>& items, bool& singleWave, std::string& error, std::atomic<float>* progress = nullptr);
+bool validatePresetBinary(const MappedFile& file, LsjbHeader& header, std::string& error);
+bool decodePresetBinaryItem(const MappedFile& file, const LsjbHeader& header, uint32_t index, PlaylistItem& item, std::string& error);
+bool openStreamingPlaylist(AudioState& state, const std::string& path);
+bool beginPlaylistItem(AudioState& state, int index);
+bool playlistEndsBefore(AudioState& state, int index);
+bool writePresetBinary(const std::string& path, const std::vector<PlaylistItem>& items, bool singleWave);
+void formatWaveText(TextWriter& out, const std::vector<FrequencyRow>& left, const std::vector<FrequencyRow>& right, bool withPhase);
+void formatPlaylistText(TextWriter& out, const std::vector<PlaylistItem>& items, bool withPhase, std::atomic<float>* progress = nullptr);
+void drawHeatmapGL(AudioState& state, ScopeGL& gl, int x, int y, int width, int height, float gain);
+std::string thumbnailCacheDir();
+bool generatePresetThumbnail(ThumbnailCache& cache, const std::string& path, IGFD_Thumbnail_Info* info);
+bool readFirstPresetItem(const std::string& path, WavePreset& bank);
+bool readThumbnailFile(const std::string& path, const std::string& key, std::vector<unsigned char>& rgba);
+bool writeThumbnailFile(const std::string& path, const std::string& key, const std::vector<unsigned char>& rgba);
+void createThumbnailTextureGL(IGFD_Thumbnail_Info* info);
+void destroyThumbnailTextureGL(IGFD_Thumbnail_Info* info);
 
 int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::strcmp(argv[1], "export") == 0) return runExportCommand(argc, argv);
+    if (argc >= 2 && std::strcmp(argv[1], "convert") == 0) return runConvertCommand(argc, argv);
     SDL_Init(SDL_INIT_VIDEO);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0); SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE); SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3); SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3); SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1); SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24); SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
     SDL_Window* window = SDL_CreateWindow("Lissajous Generator C++ [GPU Accelerated]", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 850, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_SHOWN);
@@ -107,13 +701,23 @@ int main(int argc, char* argv[]) {
     AudioState state; state.channelL.push_back(FrequencyRow(60.0f)); state.channelR.push_back(FrequencyRow(61.0f));
     Pa_Initialize(); PaStream* stream;
     Pa_OpenDefaultStream(&stream, 0, 2, paFloat32, SAMPLE_RATE, FRAMES_PER_BUFFER, audioCallback, &state);
-    GLuint shaderProgram = createShaderProgram(); GLuint vao, vbo;
-    glGenVertexArrays(1, &vao); glGenBuffers(1, &vbo);
-    glBindVertexArray(vao); glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    ScopeGL gl; gl.shaderProgram = createShaderProgram(vertexShaderSource, fragmentShaderSource);
+    glGenVertexArrays(1, &gl.vao); glGenBuffers(1, &gl.vbo);
+    glBindVertexArray(gl.vao); glBindBuffer(GL_ARRAY_BUFFER, gl.vbo);
     size_t stride = 6 * sizeof(float);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0); glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float))); glEnableVertexAttribArray(1);
+    gl.trailProgram = createShaderProgram(trailVertexShaderSource, trailFragmentShaderSource);
+    gl.markerProgram = createShaderProgram(markerVertexShaderSource, markerFragmentShaderSource);
+    glGenVertexArrays(1, &gl.trailVao);
+    glBindVertexArray(gl.trailVao); glEnableVertexAttribArray(0); glVertexAttribDivisor(0, 1); glEnableVertexAttribArray(1); glVertexAttribDivisor(1, 1);
     glBindBuffer(GL_ARRAY_BUFFER, 0); glBindVertexArray(0);
+    initHeatmapGL(gl);
+    FrameCapture capture;
+    // Static so it outlives the dialog singleton, whose thumbnail thread may still be rendering when main returns.
+    static ThumbnailCache thumbnails; thumbnails.dir = thumbnailCacheDir();
+    ImGuiFileDialog::Instance()->SetCreateThumbnailCallback(createThumbnailTextureGL); ImGuiFileDialog::Instance()->SetDestroyThumbnailCallback(destroyThumbnailTextureGL);
+    ImGuiFileDialog::Instance()->AddThumbnailGenerator(".lsj,.lsjp,.lsjb", [](const std::string& path, IGFD_Thumbnail_Info* info) { return generatePresetThumbnail(thumbnails, path, info); });
     glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); glEnable(GL_LINE_SMOOTH); glEnable(GL_PROGRAM_POINT_SIZE);
 
     bool quit = false; SDL_Event event; Uint32 lastTime = SDL_GetTicks();
@@ -121,20 +725,28 @@ int main(int argc, char* argv[]) {
     while (!quit) {
         Uint32 currentTime = SDL_GetTicks(); Uint32 frameTime = 1000 / state.targetFPS; Uint32 elapsed = currentTime - lastTime;
         if (elapsed < frameTime) { SDL_Delay(frameTime - elapsed); } lastTime = SDL_GetTicks();
-        while (SDL_PollEvent(&event)) { ImGui_ImplSDL2_ProcessEvent(&event); if (event.type == SDL_QUIT) quit = true; if (event.type == SDL_KEYDOWN) { if (event.key.keysym.sym == SDLK_LSHIFT || event.key.keysym.sym == SDLK_RSHIFT) state.shiftPressed = true; if (event.key.keysym.sym == SDLK_LCTRL || event.key.keysym.sym == SDLK_RCTRL) state.ctrlPressed = true; } if (event.type == SDL_KEYUP) { if (event.key.keysym.sym == SDLK_LSHIFT || event.key.keysym.sym == SDLK_RSHIFT) state.shiftPressed = false; if (event.key.keysym.sym == SDLK_LCTRL || event.key.keysym.sym == SDLK_RCTRL) state.ctrlPressed = false; } }
-
-        if (state.playlistPlaying && state.running && !state.playlist.empty()) {
+        while (SDL_PollEvent(&event)) { ImGui_ImplSDL2_ProcessEvent(&event); if (event.type == SDL_QUIT) quit = true; if (event.type == SDL_KEYDOWN) { if (event.key.keysym.sym == SDLK_LSHIFT || event.key.keysym.sym == SDLK_RSHIFT) state.shiftPressed = true; if (event.key.keysym.sym == SDLK_LCTRL || event.key.keysym.sym == SDLK_RCTRL) state.ctrlPressed = true; if (event.key.keysym.sym == SDLK_F12) state.screenshotRequested = true; } if (event.type == SDL_KEYUP) { if (event.key.keysym.sym == SDLK_LSHIFT || event.key.keysym.sym == SDLK_RSHIFT) state.shiftPressed = false; if (event.key.keysym.sym == SDLK_LCTRL || event.key.keysym.sym == SDLK_RCTRL) state.ctrlPressed = false; } }
+
+        // Whole-bank replacements (file loads, Apply Text, playlist items) go through publishBank; the audio thread
+        // adopts a published bank only when it can take this lock without waiting, so never mid-frame, and a stopped
+        // engine adopts it here. The lock does not guard the row widgets: audioCallback reads channelL/channelR without
+        // it, so in-place row edits are not synchronised with synthesis.
+        std::unique_lock<std::mutex> bankLock(state.bankMutex);
+        if (!state.running) adoptPendingBank(state);
+        if (state.bankAdopted.exchange(false)) state.waveDataIsDirty = true;
+        applyIoCompletions(state);
+        pollHotReload(state);
+
+        if (state.playlistPlaying && state.running && (state.stream || !state.playlist.empty())) {
             state.playlistTimer -= io.DeltaTime;
             if (state.playlistTimer <= 0.0f) {
-                state.currentPlaylistItem++;
-                if (state.currentPlaylistItem >= (int)state.playlist.size()) {
-                    if (state.loopPlaylist) state.currentPlaylistItem = 0;
+                int next = state.currentPlaylistItem + 1;
+                if (playlistEndsBefore(state, next)) {
+                    if (state.loopPlaylist) next = 0;
                     else { state.playlistPlaying = false; state.currentPlaylistItem = -1; }
                 }
-                if (state.playlistPlaying) {
-                    loadPlaylistItem(state, state.currentPlaylistItem);
-                    state.playlistTimer = state.playlist[state.currentPlaylistItem].duration;
-                }
+                // A streamed item that is not decoded yet keeps the current one playing until it is.
+                if (state.playlistPlaying && beginPlaylistItem(state, next)) state.currentPlaylistItem = next;
             }
         }
 
@@ -148,6 +760,7 @@ int main(int argc, char* argv[]) {
                 ImGui::BulletText("Play/Stop: Starts or stops the audio and visual generation.");
                 ImGui::BulletText("Mute Audio: Mutes the sound but keeps the visualization.");
                 ImGui::BulletText("Step: Shows the frequency increment. Hold Shift (0.1) or Ctrl+Shift (0.01) for fine-tuning.");
+                ImGui::BulletText("Scale Mode: Fixed scale, sliding maximum of the visible trail, or a smoothed peak follower.");
             }
             if (ImGui::CollapsingHeader("Frequency Channels (L and R)")) {
                 ImGui::BulletText("Bulk operations (+ All, - All, x2 All, /2 All): Apply operation to ALL frequencies in that channel.");
@@ -168,11 +781,14 @@ int main(int argc, char* argv[]) {
                 ImGui::BulletText("Use the format: L:{S440,Q220(M),...} R:{...}");
                 ImGui::BulletText("S, Q, W are the prefixes for the waveform type. (M) indicates it is muted.");
                 ImGui::BulletText("Click 'Apply Text' for the changes to take effect.");
+                ImGui::BulletText("Hot Reload: the active wave and playlist files are reloaded when another program saves them.");
                 ImGui::BulletText("The program will warn you if there is a syntax error in the text.");
             }
             if (ImGui::CollapsingHeader("Playlist")) {
                 ImGui::BulletText("Allows creating a sequence of waves with different durations.");
                 ImGui::BulletText("'Add Current -> Playlist' adds the current configuration to the list.");
+                ImGui::BulletText("Ctrl+click and Shift+click select several items; the buttons above the list act on the selection.");
+                ImGui::BulletText("Double-click an item to load it, or to jump to it while the playlist plays.");
             }
             ImGui::Separator();
             ImGui::Text("Credits:");
@@ -256,76 +872,7 @@ int main(int argc, char* argv[]) {
         ImGui::PopStyleColor(3);
 
         if (leftHeaderOpen) {
-            for (int i = 0; i < (int)state.channelL.size(); i++) {
-                ImGui::PushID(i);
-                ImGui::Button(":::");
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Drag to reorder in the same channel.\nDrag to the other channel's header to move.\nHold SHIFT while dragging to copy it to the opposite channel");
-                if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
-                    DragPayload payload_data = { i, 'L' };
-                    ImGui::SetDragDropPayload("FREQ_ROW", &payload_data, sizeof(DragPayload));
-                    ImGui::Text("Move %.2f Hz (%c)", state.channelL[i].freq, "SQW"[(int)state.channelL[i].type]);
-                    ImGui::EndDragDropSource();
-                }
-                if (ImGui::BeginDragDropTarget()) {
-                    if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("FREQ_ROW")) {
-                        const DragPayload& payload_n = *(const DragPayload*)payload->Data;
-                        if (payload_n.sourceChannel == 'L' && payload_n.sourceIndex != i) {
-                            FrequencyRow temp = state.channelL[payload_n.sourceIndex];
-                            state.channelL.erase(state.channelL.begin() + payload_n.sourceIndex);
-                            state.channelL.insert(state.channelL.begin() + i, temp);
-                            state.waveDataIsDirty = true;
-                        }
-                    }
-                    ImGui::EndDragDropTarget();
-                }
-                ImGui::SameLine(); ImGui::SetNextItemWidth(80);
-                if (ImGui::InputFloat("Hz", &state.channelL[i].freq, 0.0f, 0.0f, "%.3f")) state.waveDataIsDirty = true;
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Frequency in Hertz for this oscillator.");
-                ImGui::SameLine();
-                if (ImGui::Button("+")) { state.channelL[i].freq += getStep(state.shiftPressed, state.ctrlPressed); state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Increase frequency by the Step value.\nHold Shift or Ctrl+Shift for fine tuning.");
-                ImGui::SameLine();
-                if (ImGui::Button("-")) { state.channelL[i].freq -= getStep(state.shiftPressed, state.ctrlPressed); state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Decrease frequency by the Step value.\nHold Shift or Ctrl+Shift for fine tuning.");
-                ImGui::SameLine();
-                if (ImGui::Button("x2")) { state.channelL[i].freq *= 2.0f; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Multiply frequency by 2 (goes up one octave).");
-                ImGui::SameLine();
-                if (ImGui::Button("/2")) { state.channelL[i].freq /= 2.0f; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Divide frequency by 2 (goes down one octave).");
-                ImGui::SameLine();
-                bool isSine = state.channelL[i].type == SINE;
-                if (isSine) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.2f, 1.0f));
-                if (ImGui::Button("S")) { state.channelL[i].type = SINE; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Sine.");
-                if (isSine) ImGui::PopStyleColor();
-                ImGui::SameLine(0, 2);
-                bool isSquare = state.channelL[i].type == SQUARE;
-                if (isSquare) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
-                if (ImGui::Button("Q")) { state.channelL[i].type = SQUARE; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Square.");
-                if (isSquare) ImGui::PopStyleColor();
-                ImGui::SameLine(0, 2);
-                bool isSaw = state.channelL[i].type == SAWTOOTH;
-                if (isSaw) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.6f, 1.0f));
-                if (ImGui::Button("W")) { state.channelL[i].type = SAWTOOTH; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Sawtooth.");
-                if (isSaw) ImGui::PopStyleColor();
-                ImGui::SameLine();
-                if (ImGui::Checkbox("M", &state.channelL[i].muted)) state.waveDataIsDirty = true;
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Mute only this frequency.");
-                ImGui::SameLine();
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(50 / 255.0f, 130 / 255.0f, 0 / 255.0f, 1.0f));
-                if (ImGui::Button("D")) { state.channelL.insert(state.channelL.begin() + i + 1, state.channelL[i]); state.waveDataIsDirty = true; ImGui::PopStyleColor(); ImGui::PopID(); break; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Duplicate this frequency row.");
-                ImGui::PopStyleColor();
-                ImGui::SameLine();
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
-                if (ImGui::Button("X")) { state.channelL.erase(state.channelL.begin() + i); state.waveDataIsDirty = true; ImGui::PopStyleColor(); ImGui::PopID(); break; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Remove this frequency row.");
-                ImGui::PopStyleColor();
-                ImGui::PopID();
-            }
+            drawFrequencyRows(state, state.channelL, 'L');
             if (ImGui::Button("+ Add Frequency##L")) { state.channelL.push_back(FrequencyRow(440.0f)); state.waveDataIsDirty = true; }
             if (ImGui::IsItemHovered()) ImGui::SetTooltip("Add a new oscillator to this channel.");
         }
@@ -381,76 +928,7 @@ int main(int argc, char* argv[]) {
         ImGui::PopStyleColor(3);
 
         if (rightHeaderOpen) {
-            for (int i = 0; i < (int)state.channelR.size(); i++) {
-                ImGui::PushID(1000 + i);
-                ImGui::Button(":::");
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Drag to reorder in the same channel.\nDrag to the other channel's header to move.\nHold SHIFT while dropping to clone.");
-                if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
-                    DragPayload payload_data = { i, 'R' };
-                    ImGui::SetDragDropPayload("FREQ_ROW", &payload_data, sizeof(DragPayload));
-                    ImGui::Text("Move %.2f Hz (%c)", state.channelR[i].freq, "SQW"[(int)state.channelR[i].type]);
-                    ImGui::EndDragDropSource();
-                }
-                if (ImGui::BeginDragDropTarget()) {
-                    if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("FREQ_ROW")) {
-                        const DragPayload& payload_n = *(const DragPayload*)payload->Data;
-                        if (payload_n.sourceChannel == 'R' && payload_n.sourceIndex != i) {
-                            FrequencyRow temp = state.channelR[payload_n.sourceIndex];
-                            state.channelR.erase(state.channelR.begin() + payload_n.sourceIndex);
-                            state.channelR.insert(state.channelR.begin() + i, temp);
-                            state.waveDataIsDirty = true;
-                        }
-                    }
-                    ImGui::EndDragDropTarget();
-                }
-                ImGui::SameLine(); ImGui::SetNextItemWidth(80);
-                if (ImGui::InputFloat("Hz", &state.channelR[i].freq, 0.0f, 0.0f, "%.3f")) state.waveDataIsDirty = true;
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Frequency in Hertz for this oscillator.");
-                ImGui::SameLine();
-                if (ImGui::Button("+")) { state.channelR[i].freq += getStep(state.shiftPressed, state.ctrlPressed); state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Increase frequency by the Step value.\nHold Shift or Ctrl+Shift for fine tuning.");
-                ImGui::SameLine();
-                if (ImGui::Button("-")) { state.channelR[i].freq -= getStep(state.shiftPressed, state.ctrlPressed); state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Decrease frequency by the Step value.\nHold Shift or Ctrl+Shift for fine tuning.");
-                ImGui::SameLine();
-                if (ImGui::Button("x2")) { state.channelR[i].freq *= 2.0f; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Multiply frequency by 2 (goes up one octave).");
-                ImGui::SameLine();
-                if (ImGui::Button("/2")) { state.channelR[i].freq /= 2.0f; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Divide frequency by 2 (goes down one octave).");
-                ImGui::SameLine();
-                bool isSine = state.channelR[i].type == SINE;
-                if (isSine) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.2f, 1.0f));
-                if (ImGui::Button("S")) { state.channelR[i].type = SINE; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Sine.");
-                if (isSine) ImGui::PopStyleColor();
-                ImGui::SameLine(0, 2);
-                bool isSquare = state.channelR[i].type == SQUARE;
-                if (isSquare) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
-                if (ImGui::Button("Q")) { state.channelR[i].type = SQUARE; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Square.");
-                if (isSquare) ImGui::PopStyleColor();
-                ImGui::SameLine(0, 2);
-                bool isSaw = state.channelR[i].type == SAWTOOTH;
-                if (isSaw) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.6f, 1.0f));
-                if (ImGui::Button("W")) { state.channelR[i].type = SAWTOOTH; state.waveDataIsDirty = true; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Sawtooth.");
-                if (isSaw) ImGui::PopStyleColor();
-                ImGui::SameLine();
-                if (ImGui::Checkbox("M", &state.channelR[i].muted)) state.waveDataIsDirty = true;
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Mute only this frequency.");
-                ImGui::SameLine();
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(50 / 255.0f, 130 / 255.0f, 0 / 255.0f, 1.0f));
-                if (ImGui::Button("D")) { state.channelR.insert(state.channelR.begin() + i + 1, state.channelR[i]); state.waveDataIsDirty = true; ImGui::PopStyleColor(); ImGui::PopID(); break; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Duplicate this frequency row.");
-                ImGui::PopStyleColor();
-                ImGui::SameLine();
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
-                if (ImGui::Button("X")) { state.channelR.erase(state.channelR.begin() + i); state.waveDataIsDirty = true; ImGui::PopStyleColor(); ImGui::PopID(); break; }
-                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Remove this frequency row.");
-                ImGui::PopStyleColor();
-                ImGui::PopID();
-            }
+            drawFrequencyRows(state, state.channelR, 'R');
             if (ImGui::Button("+ Add Frequency##R")) { state.channelR.push_back(FrequencyRow(440.0f)); state.waveDataIsDirty = true; }
             if (ImGui::IsItemHovered()) ImGui::SetTooltip("Add a new oscillator to this channel.");
         }
@@ -458,6 +936,51 @@ int main(int argc, char* argv[]) {
 
         ImGui::SliderInt("Trail %", &state.trailPercent, 1, 100);
         if (ImGui::IsItemHovered()) ImGui::SetTooltip("Defines the length of the wave's trail.");
+        int decimationFactor = state.decimator.factor.load(), decimationMethod = state.decimator.method.load();
+        if (ImGui::SliderInt("Decimation", &decimationFactor, 1, 256, "1/%d", ImGuiSliderFlags_Logarithmic)) state.decimator.factor = (std::max)(1, decimationFactor);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Audio samples per trail bucket.\nHigher values make the trail cover more time.");
+        if (ImGui::Combo("Decimation Method", &decimationMethod, "Drop\0Average\0Min/Max\0")) state.decimator.method = decimationMethod;
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Drop: keep the first sample of each bucket.\nAverage: mean of the bucket.\nMin/Max: keep the bucket's extremes so peaks are not lost.");
+        int lengthIndex = 0; while (lengthIndex < 6 && (BUFFER_SIZE << (2 * lengthIndex)) < state.trailLength) lengthIndex++;
+        if (ImGui::Combo("Trail Length", &lengthIndex, "4K\0" "16K\0" "64K\0" "256K\0" "1M\0" "4M\0" "16M\0")) state.trailLength = BUFFER_SIZE << (2 * lengthIndex);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Number of trail points kept on the GPU.\nLong trails are drawn from a reduced level of detail.");
+        ImGui::SameLine(); ImGui::TextDisabled("(%.2f s)", state.trailLength * state.trailPercent / 100.0f / state.decimator.pointRate());
+        ImGui::Combo("Render Mode", &state.renderMode, "Trail\0Heatmap\0");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Trail: fading line through the recent samples.\nHeatmap: density of every sample at the full sample rate.");
+        if (state.renderMode == RENDER_TRAIL) {
+            ImGui::SliderFloat("Line Width", &state.lineWidth, 0.5f, 8.0f, "%.1f px");
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Thickness of the trail in pixels.");
+        }
+        else {
+            int sizeIndex = state.heatmapSize >= 2048 ? 3 : state.heatmapSize >= 1024 ? 2 : state.heatmapSize >= 512 ? 1 : 0;
+            if (ImGui::Combo("Heatmap Size", &sizeIndex, "256\0" "512\0" "1024\0" "2048\0")) state.heatmapSize = 256 << sizeIndex;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Resolution of the accumulation texture, independent of the window.");
+            ImGui::SliderFloat("Persistence", &state.heatPersistence, 0.05f, 10.0f, "%.2f s", ImGuiSliderFlags_Logarithmic);
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Time for the accumulated density to fade to about a third.");
+            ImGui::Combo("Tone Map", &state.heatToneMap, "Log\0Gamma\0");
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("How hit counts are mapped to the color scale.");
+            ImGui::SliderFloat("Full Scale", &state.heatFullScale, 1.0f, 10000.0f, "%.0f hits", ImGuiSliderFlags_Logarithmic);
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Hit count that maps to the top of the color scale.");
+            if (state.heatToneMap == TONEMAP_GAMMA) {
+                ImGui::SliderFloat("Gamma", &state.heatGamma, 0.5f, 5.0f, "%.2f");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Gamma applied to the normalized hit count.");
+            }
+        }
+        int scaleMode = state.normalizer.mode.load();
+        if (ImGui::Combo("Scale Mode", &scaleMode, "Fixed\0Sliding Max\0Smoothed Peak\0")) state.normalizer.mode = scaleMode;
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("How the figure is scaled to the scope.\nFixed: constant full-scale amplitude.\nSliding Max: peak of the visible trail.\nSmoothed Peak: peak follower with attack and release.");
+        if (scaleMode == SCALE_FIXED) {
+            float fixedScale = state.normalizer.fixedScale.load();
+            if (ImGui::SliderFloat("Full Scale", &fixedScale, 0.05f, 2.0f, "%.2f")) state.normalizer.fixedScale = fixedScale;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Amplitude that reaches the outer circle.");
+        }
+        else if (scaleMode == SCALE_SMOOTHED_PEAK) {
+            float attackMs = state.normalizer.attackMs.load(), releaseMs = state.normalizer.releaseMs.load();
+            if (ImGui::SliderFloat("Attack (ms)", &attackMs, 0.1f, 500.0f, "%.1f ms")) state.normalizer.attackMs = attackMs;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("How fast the scale follows rising peaks.");
+            if (ImGui::SliderFloat("Release (ms)", &releaseMs, 10.0f, 5000.0f, "%.0f ms")) state.normalizer.releaseMs = releaseMs;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("How fast the scale relaxes after peaks fall.");
+        }
         ImGui::Separator();
 
         ImGui::Checkbox("Show Start/End Points", &state.showStartEndPoints);
@@ -484,6 +1007,27 @@ int main(int argc, char* argv[]) {
         ImGui::SliderInt("Target FPS", &state.targetFPS, 60, 480);
         if (ImGui::IsItemHovered()) ImGui::SetTooltip("Sets the target FPS for rendering.\nHigher values may result in smoother animation.");
 
+        if (ImGui::CollapsingHeader("Instrumentation")) {
+            ImGui::Checkbox("Sync to Audio", &state.syncToAudio);
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Delays the scope by the output latency so the picture matches what is heard,\nusing the DAC timestamps reported by the audio device.");
+            ImGui::Text("Output latency: %.1f ms", state.blockClock.outputLatency.load() * 1000.0);
+            ImGui::Text("Display offset: %.1f ms", state.displayLagMs);
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("How far behind the newest synthesized sample the scope is drawn this frame.");
+        }
+
+        if (ImGui::CollapsingHeader("Capture")) {
+            if (ImGui::Button("Screenshot")) state.screenshotRequested = true;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Save the scope as an image (F12).");
+            ImGui::SameLine();
+            if (ImGui::Checkbox("Record", &state.recording) && state.recording) { capture.sessionId = (long long)std::time(nullptr); capture.sequenceFrame = 0; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Save every rendered frame of the scope as a numbered sequence.");
+            ImGui::SameLine(); ImGui::SetNextItemWidth(100);
+            ImGui::Combo("Format", &state.captureFormat, "PNG\0Raw RGBA\0");
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("PNG images, or raw top-down RGBA frames for piping into an encoder.");
+            ImGui::InputText("Output Folder", state.captureDir, sizeof(state.captureDir));
+            ImGui::Text("Written: %d  Dropped: %d  Failed: %d  Queued: %d", capture.framesWritten.load(), capture.framesDropped, capture.framesFailed.load(), capture.encoders.pending.load());
+        }
+
         ImGui::Separator();
         ImGui::BeginChild("Status", ImVec2(0, 180), false, ImGuiWindowFlags_None);
 
@@ -492,31 +1036,28 @@ int main(int argc, char* argv[]) {
             state.waveDataIsDirty = false;
         }
 
-        ImGui::InputTextMultiline("##WaveEditor", state.waveTextBuffer, sizeof(state.waveTextBuffer),
-            ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 4), ImGuiInputTextFlags_AllowTabInput);
+        // Typing invalidates the token index; the next reformat rebuilds it, discarding unapplied edits as before.
+        if (ImGui::InputTextMultiline("##WaveEditor", (char*)state.waveEditor.text.c_str(), state.waveEditor.text.capacity() + 1,
+            ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 4), ImGuiInputTextFlags_AllowTabInput | ImGuiInputTextFlags_CallbackResize, waveTextResizeCallback, &state.waveEditor.text))
+            state.waveEditor.indexValid = false;
         if (ImGui::IsItemHovered()) ImGui::SetTooltip("Directly edit the wave configuration here.\nFormat: L:{S440,Q220(M),...}\nThen press 'Apply Text'.");
 
-        if (ImGui::Button("Apply Text")) { if (parseTextBufferToWave(state)) state.waveDataIsDirty = true; }
+        if (ImGui::Button("Apply Text")) parseTextBufferToWave(state);
         if (ImGui::IsItemHovered()) ImGui::SetTooltip("Parse the text above and apply changes to the wave.");
 
         ImGui::SameLine();
-        if (ImGui::Button("Save Wave")) {
-#ifdef _WIN32
-            std::string path = saveFileDialog("Lissajous Wave (*.lsj)\0*.lsj\0All Files (*.*)\0*.*\0", "lsj");
-            if (!path.empty()) saveWaveToFile(path, state);
-#endif
-        }
+        if (ImGui::Button("Save Wave")) openPresetDialog(state, "SaveWave", "Save Wave", "Lissajous Wave{.lsj},Lissajous Binary{.lsjb},.*", state.currentWaveFile);
         if (ImGui::IsItemHovered()) ImGui::SetTooltip("Save the current wave configuration to a .lsj file.");
 
         ImGui::SameLine();
-        if (ImGui::Button("Load Wave")) {
-#ifdef _WIN32
-            std::string path = openFileDialog("Lissajous Wave (*.lsj)\0*.lsj\0All Files (*.*)\0*.*\0", "lsj");
-            if (!path.empty()) loadWaveFromFile(path, state);
-#endif
-        }
+        if (ImGui::Button("Load Wave")) openPresetDialog(state, "LoadWave", "Load Wave", "Lissajous Wave{.lsj,.lsjb},.*", "");
         if (ImGui::IsItemHovered()) ImGui::SetTooltip("Load a wave configuration from a .lsj file.");
 
+        ImGui::SameLine();
+        ImGui::Checkbox("Hot Reload", &state.hotReload);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Reload the active wave and playlist files when another program changes them.\nParse errors are shown below and the sound keeps playing.");
+        drawIoProgress(state);
+
         if (!state.parseErrorMsg.empty()) {
             ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
             ImGui::TextWrapped("Error: %s", state.parseErrorMsg.c_str());
@@ -528,13 +1069,11 @@ int main(int argc, char* argv[]) {
 
         if (ImGui::CollapsingHeader("Playlist", ImGuiTreeNodeFlags_DefaultOpen)) {
             if (ImGui::Button(state.playlistPlaying ? "Stop Playlist" : "Play Playlist")) {
-                if (!state.playlist.empty()) {
+                if (state.stream || !state.playlist.empty()) {
                     state.playlistPlaying = !state.playlistPlaying;
                     if (state.playlistPlaying) {
                         if (!state.running) { Pa_StartStream(stream); state.running = true; }
-                        state.currentPlaylistItem = 0;
-                        loadPlaylistItem(state, 0);
-                        state.playlistTimer = state.playlist[0].duration;
+                        state.currentPlaylistItem = -1; state.playlistTimer = 0.0f;
                     }
                 }
             }
@@ -544,262 +1083,961 @@ int main(int argc, char* argv[]) {
             ImGui::Checkbox("Loop", &state.loopPlaylist);
             if (ImGui::IsItemHovered()) ImGui::SetTooltip("If checked, the playlist will loop back to the start when it finishes.");
 
-            ImGui::SameLine();
-            if (ImGui::Button("Add Current -> Playlist")) {
-                PlaylistItem newItem;
-                newItem.preset.freqsL = state.channelL;
-                newItem.preset.freqsR = state.channelR;
-                state.playlist.push_back(newItem);
+            if (state.stream) {
+                StreamingPlaylist& s = *state.stream;
+                size_t indexed, decoded; bool done; std::string error;
+                { std::lock_guard<std::mutex> lock(s.mutex); indexed = s.available(); decoded = s.window.size(); done = s.binary || s.indexDone; error = s.error; }
+                ImGui::Separator();
+                ImGui::TextWrapped("Streaming %s", s.path.c_str());
+                ImGui::Text("%zu items%s, %zu decoded ahead, playing item %d", indexed, done ? "" : " indexed so far", decoded, state.currentPlaylistItem);
+                if (!error.empty()) ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", error.c_str());
+                if (ImGui::Button("Close Stream")) { state.stream.reset(); state.playlistPlaying = false; state.currentPlaylistItem = -1; }
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Stop streaming and go back to the editable playlist.");
             }
-            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Adds the current wave configuration as a new item in the playlist.");
-            ImGui::Separator();
-
-            for (int i = 0; i < (int)state.playlist.size(); ++i) {
-                ImGui::PushID(2000 + i);
-                bool isCurrent = state.playlistPlaying && i == state.currentPlaylistItem;
-                if (isCurrent) ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.3f, 0.6f, 0.9f, 1.0f));
-
-                std::stringstream label;
-                label.precision(1);
-                label << std::fixed << "Item " << i << " (" << state.playlist[i].duration << "s)";
-
-                if (ImGui::CollapsingHeader(label.str().c_str())) {
-                    ImGui::SliderFloat("Duration (s)", &state.playlist[i].duration, 0.1f, 60.0f, "%.2f s");
-                    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Sets how long this playlist item will play.");
-                    ImGui::Separator();
-                    if (ImGui::Button("Remove")) { state.playlist.erase(state.playlist.begin() + i); ImGui::PopID(); break; }
-                    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Remove this item from the playlist.");
-                    ImGui::SameLine();
-                    if (ImGui::Button("Up") && i > 0) { std::swap(state.playlist[i], state.playlist[i - 1]); }
-                    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Move this item up in the playlist order.");
-                    ImGui::SameLine();
-                    if (ImGui::Button("Down") && i < (int)state.playlist.size() - 1) { std::swap(state.playlist[i], state.playlist[i + 1]); }
-                    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Move this item down in the playlist order.");
+            else {
+                ImGui::SameLine();
+                if (ImGui::Button("Add Current -> Playlist")) {
+                    PlaylistItem newItem;
+                    newItem.preset.freqsL = state.channelL;
+                    newItem.preset.freqsR = state.channelR;
+                    state.playlist.push_back(newItem);
                 }
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Adds the current wave configuration as a new item in the playlist.");
+                ImGui::Separator();
 
-                if (isCurrent) ImGui::PopStyleColor();
-                ImGui::PopID();
-            }
+                drawPlaylistTable(state);
 
-            ImGui::Separator();
-            if (ImGui::Button("Save Playlist")) {
-#ifdef _WIN32
-                std::string path = saveFileDialog("Lissajous Playlist (*.lsjp)\0*.lsjp\0All Files (*.*)\0*.*\0", "lsjp");
-                if (!path.empty()) savePlaylistToFile(path, state);
-#endif
-            }
-            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Save the entire playlist to a .lsjp file.");
+                ImGui::Separator();
+                if (ImGui::Button("Save Playlist")) openPresetDialog(state, "SavePlaylist", "Save Playlist", "Lissajous Playlist{.lsjp},Lissajous Binary{.lsjb},.*", state.currentPlaylistFile);
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Save the entire playlist to a .lsjp file.");
 
-            ImGui::SameLine();
-            if (ImGui::Button("Load Playlist")) {
-#ifdef _WIN32
-                std::string path = openFileDialog("Lissajous Playlist (*.lsjp)\0*.lsjp\0All Files (*.*)\0*.*\0", "lsjp");
-                if (!path.empty()) loadPlaylistFromFile(path, state);
-#endif
-            }
-            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Load a playlist from a .lsjp file.");
+                ImGui::SameLine();
+                if (ImGui::Button("Load Playlist")) openPresetDialog(state, "LoadPlaylist", "Load Playlist", "Lissajous Playlist{.lsjp,.lsjb},.*", "");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Load a playlist from a .lsjp file.");
 
-            ImGui::SameLine();
-            if (ImGui::Button("Clear Playlist")) { state.playlist.clear(); }
-            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Removes all items from the current playlist.");
+                ImGui::SameLine();
+                if (ImGui::Button("Stream Playlist")) openPresetDialog(state, "StreamPlaylist", "Stream Playlist", "Lissajous Playlist{.lsjp,.lsjb},.*", "");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Play a very large playlist straight from disk without loading it.\nThe playlist is read-only while streaming.");
+
+                ImGui::SameLine();
+                if (ImGui::Button("Clear Playlist")) { state.playlist.clear(); }
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Removes all items from the current playlist.");
+                drawIoProgress(state);
+            }
         }
 
         ImGui::End();
+        drawFileDialogs(state);
+        bankLock.unlock();
 
         ImGui::Render();
         glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y); glClearColor(0.0f, 0.0f, 0.0f, 1.0f); glClear(GL_COLOR_BUFFER_BIT);
         int w, h; SDL_GetWindowSize(window, &w, &h);
         int lissajous_size = (std::min)(w - 620, h - 90);
-        drawLissajousGL(state, 620, 80, lissajous_size, lissajous_size, shaderProgram, vao, vbo);
+        state.streamTime = state.running ? Pa_GetStreamTime(stream) : 0.0;
+        drawLissajousGL(state, 620, 80, lissajous_size, lissajous_size, gl);
+        captureScopeGL(state, capture, 620, 80, lissajous_size, lissajous_size);
+        ImGuiFileDialog::Instance()->ManageGPUThumbnails();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         SDL_GL_SwapWindow(window);
     }
 
     if (state.running) Pa_StopStream(stream); Pa_CloseStream(stream); Pa_Terminate();
-    glDeleteVertexArrays(1, &vao); glDeleteBuffers(1, &vbo); glDeleteProgram(shaderProgram);
+    finishCaptureGL(capture, true);
+    for (auto& slot : capture.slots) glDeleteBuffers(1, &slot.pbo);
+    glDeleteVertexArrays(1, &gl.vao); glDeleteBuffers(1, &gl.vbo); glDeleteProgram(gl.shaderProgram);
+    glDeleteVertexArrays(1, &gl.trailVao); glDeleteProgram(gl.trailProgram); glDeleteProgram(gl.markerProgram);
+    for (auto& level : gl.store.levels) glDeleteBuffers(1, &level.vbo);
+    glDeleteVertexArrays(1, &gl.heatVao); glDeleteVertexArrays(1, &gl.fullscreenVao); glDeleteBuffers(1, &gl.heatVbo); glDeleteProgram(gl.heatSplatProgram); glDeleteProgram(gl.heatDecayProgram); glDeleteProgram(gl.heatDisplayProgram);
+    glDeleteFramebuffers(1, &gl.heatFbo); glDeleteTextures(1, &gl.heatTex); glDeleteTextures(1, &gl.lutTex);
     ImGui_ImplOpenGL3_Shutdown(); ImGui_ImplSDL2_Shutdown(); ImGui::DestroyContext();
     SDL_GL_DeleteContext(gl_context); SDL_DestroyWindow(window); SDL_Quit();
     return 0;
 }
 
-#ifdef _WIN32
-std::string openFileDialog(const char* filter, const char* defExt) {
-    OPENFILENAMEA ofn; CHAR szFile[260] = { 0 }; ZeroMemory(&ofn, sizeof(OPENFILENAME));
-    ofn.lStructSize = sizeof(OPENFILENAME); ofn.hwndOwner = NULL; ofn.lpstrFile = szFile;
-    ofn.nMaxFile = sizeof(szFile); ofn.lpstrFilter = filter; ofn.nFilterIndex = 1;
-    ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_NOCHANGEDIR;
-    ofn.lpstrDefExt = defExt;
-    if (GetOpenFileNameA(&ofn) == TRUE) return ofn.lpstrFile; return std::string();
-}
-std::string saveFileDialog(const char* filter, const char* defExt) {
-    OPENFILENAMEA ofn; CHAR szFile[260] = { 0 }; ZeroMemory(&ofn, sizeof(OPENFILENAME));
-    ofn.lStructSize = sizeof(OPENFILENAME); ofn.hwndOwner = NULL; ofn.lpstrFile = szFile;
-    ofn.nMaxFile = sizeof(szFile); ofn.lpstrFilter = filter; ofn.nFilterIndex = 1;
-    ofn.Flags = OFN_PATHMUSTEXIST | OFN_OVERWRITEPROMPT | OFN_NOCHANGEDIR;
-    ofn.lpstrDefExt = defExt;
-    if (GetSaveFileNameA(&ofn) == TRUE) return ofn.lpstrFile; return std::string();
+// Text box format: L:{row,row,...} and R:{...}, each exactly once, in either order.
+bool parseWaveText(std::string_view text, WavePreset& bank, ParseError& error) {
+    WaveScanner scan(text); bool seenL = false, seenR = false;
+    bank.freqsL.clear(); bank.freqsR.clear();
+    for (;;) {
+        scan.skipSpace(true);
+        if (scan.atEnd()) break;
+        char channel = scan.peek();
+        if ((channel != 'L' && channel != 'R') || scan.text.compare(scan.pos + 1, 2, ":{") != 0) { scan.fail("expected L:{ or R:{"); break; }
+        bool& seen = channel == 'L' ? seenL : seenR;
+        if (seen) { scan.fail("channel appears twice"); break; }
+        seen = true; scan.pos += 3;
+        if (!scan.parseRowList(channel == 'L' ? bank.freqsL : bank.freqsR, '}')) break;
+        scan.pos++;
+    }
+    if (!scan.error.message && (!seenL || !seenR)) scan.fail("invalid format, use L:{...} and R:{...}");
+    error = scan.error; return !error.message;
 }
-#endif
 
-std::string formatRowToString(const FrequencyRow& row) {
-    std::stringstream ss;
-    ss.precision(3); ss << std::fixed;
-    if (row.type == SQUARE) ss << "Q"; else if (row.type == SAWTOOTH) ss << "W"; else ss << "S";
-    ss << row.freq;
-    if (row.muted) ss << "(M)";
-    return ss.str();
+// .lsj: "L:" and "R:" lines of rows; any other line is ignored.
+bool parseWaveFile(std::string_view text, WavePreset& bank, ParseError& error) {
+    WaveScanner scan(text);
+    bank.freqsL.clear(); bank.freqsR.clear();
+    while (!scan.atEnd()) {
+        bool left = scan.startsWith("L:");
+        if (left || scan.startsWith("R:")) { scan.pos += 2; if (!scan.parseRowList(left ? bank.freqsL : bank.freqsR, '\n')) break; }
+        scan.skipLine();
+    }
+    error = scan.error; return !error.message;
 }
 
-FrequencyRow parseRowFromString(const std::string& token_str) {
-    std::string token = token_str;
-    bool isMuted = token.find("(M)") != std::string::npos;
-    if (isMuted) token.erase(token.find("(M)"));
-    WaveType type = SINE;
-    if (!token.empty()) {
-        char firstChar = (char)toupper(token[0]);
-        if (firstChar == 'Q') { type = SQUARE; token = token.substr(1); }
-        else if (firstChar == 'W') { type = SAWTOOTH; token = token.substr(1); }
-        else if (firstChar == 'S') { type = SINE; token = token.substr(1); }
+// .lsjp: each "ITEM" line starts an item followed by optional "DURATION:", "L:" and "R:" lines. Items with no rows are dropped.
+bool parsePlaylistFile(std::string_view text, std::vector<PlaylistItem>& items, ParseError& error, std::atomic<float>* progress) {
+    WaveScanner scan(text);
+    items.clear();
+    while (!scan.atEnd()) {
+        if (scan.startsWith("ITEM")) {
+            if (!items.empty() && items.back().preset.freqsL.empty() && items.back().preset.freqsR.empty()) items.back() = PlaylistItem();
+            else items.emplace_back();
+            if (progress && (items.size() & 1023) == 0) progress->store((float)scan.pos / text.size(), std::memory_order_relaxed);
+        }
+        else if (!items.empty() && scan.startsWith("DURATION:")) {
+            scan.pos += 9; scan.skipSpace(false);
+            if (!scan.parseNumber(items.back().duration)) break;
+        }
+        else if (!items.empty() && (scan.startsWith("L:") || scan.startsWith("R:"))) {
+            bool left = scan.peek() == 'L'; scan.pos += 2;
+            if (!scan.parseRowList(left ? items.back().preset.freqsL : items.back().preset.freqsR, '\n')) break;
+        }
+        scan.skipLine();
+    }
+    if (!items.empty() && items.back().preset.freqsL.empty() && items.back().preset.freqsR.empty()) items.pop_back();
+    error = scan.error; return !error.message;
+}
+
+bool readFileToString(const std::string& path, std::string& out) {
+    FILE* file = std::fopen(path.c_str(), "rb"); if (!file) return false;
+    std::fseek(file, 0, SEEK_END); long size = std::ftell(file); std::fseek(file, 0, SEEK_SET);
+    out.resize(size > 0 ? (size_t)size : 0);
+    size_t read = out.empty() ? 0 : std::fread(&out[0], 1, out.size(), file);
+    std::fclose(file); out.resize(read);
+    return true;
+}
+
+bool writeFileFromBuffer(const std::string& path, const TextWriter& writer) {
+    FILE* file = std::fopen(path.c_str(), "wb"); if (!file) return false;
+    bool ok = std::fwrite(writer.data.data(), 1, writer.size, file) == writer.size;
+    return std::fclose(file) == 0 && ok;
+}
+
+std::string formatParseError(const std::string& source, const ParseError& error) {
+    char message[256];
+    std::snprintf(message, sizeof(message), "%s%sline %d, column %d: %s", source.c_str(), source.empty() ? "" : ": ", error.line, error.column, error.message);
+    return message;
+}
+
+bool writeWaveBank(const std::string& path, const WavePreset& bank, TextWriter& out) {
+    if (hasExtension(path, ".lsjb")) {
+        std::vector<PlaylistItem> items(1); items[0].preset = bank;
+        for (auto* rows : { &items[0].preset.freqsL, &items[0].preset.freqsR }) for (auto& row : *rows) row.phase = 0.0;
+        return writePresetBinary(path, items, true);
     }
-    FrequencyRow newRow(std::stof(token));
-    newRow.muted = isMuted;
-    newRow.type = type;
-    return newRow;
+    formatWaveText(out, bank.freqsL, bank.freqsR, false); return writeFileFromBuffer(path, out);
 }
 
-void saveWaveToFile(const std::string& path, AudioState& state) {
-    std::ofstream file(path); if (!file.is_open()) return;
-    file << "L:";
-    for (size_t i = 0; i < state.channelL.size(); ++i) { file << formatRowToString(state.channelL[i]) << (i < state.channelL.size() - 1 ? "," : ""); }
-    file << "\n";
-    file << "R:";
-    for (size_t i = 0; i < state.channelR.size(); ++i) { file << formatRowToString(state.channelR[i]) << (i < state.channelR.size() - 1 ? "," : ""); }
-    file << "\n";
-    state.currentWaveFile = path;
+// Reads a .lsj or single-wave .lsjb into `bank`; on failure `error` says where, and `bank` is unspecified.
+bool readWaveBank(const std::string& path, WavePreset& bank, std::string& error) {
+    if (hasExtension(path, ".lsjb")) {
+        std::vector<PlaylistItem> items; bool singleWave;
+        if (!readPresetBinary(path, items, singleWave, error)) { error = path + ": " + error; return false; }
+        if (items.empty()) { error = path + ": file holds no wave"; return false; }
+        bank = std::move(items[0].preset);
+        return true;
+    }
+    std::string text; if (!readFileToString(path, text)) { error = path + ": cannot open file"; return false; }
+    ParseError parseError;
+    if (!parseWaveFile(text, bank, parseError)) { error = formatParseError(path, parseError); return false; }
+    return true;
 }
 
 void loadWaveFromFile(const std::string& path, AudioState& state) {
-    std::ifstream file(path); if (!file.is_open()) return;
-    state.channelL.clear(); state.channelR.clear();
-    std::string line;
-    while (std::getline(file, line)) {
-        std::vector<FrequencyRow>* targetChannel = nullptr;
-        std::string data;
-        if (line.rfind("L:", 0) == 0) { targetChannel = &state.channelL; data = line.substr(2); }
-        else if (line.rfind("R:", 0) == 0) { targetChannel = &state.channelR; data = line.substr(2); }
-        if (targetChannel) {
-            std::stringstream ss(data); std::string token;
-            while (std::getline(ss, token, ',')) {
-                if (token.empty()) continue;
-                try { targetChannel->push_back(parseRowFromString(token)); }
-                catch (...) {}
+    if (!readWaveBank(path, state.parseBank, state.parseErrorMsg)) return;
+    std::swap(state.channelL, state.parseBank.freqsL); std::swap(state.channelR, state.parseBank.freqsR);
+    state.parseErrorMsg.clear(); state.currentWaveFile = path; state.waveDataIsDirty = true;
+}
+
+bool writePlaylistItems(const std::string& path, const std::vector<PlaylistItem>& items, TextWriter& out, std::atomic<float>* progress) {
+    if (hasExtension(path, ".lsjb")) return writePresetBinary(path, items, false);
+    formatPlaylistText(out, items, false, progress); return writeFileFromBuffer(path, out);
+}
+
+void formatWaveText(TextWriter& out, const std::vector<FrequencyRow>& left, const std::vector<FrequencyRow>& right, bool withPhase) {
+    out.clear(); out.put("L:"); out.putRows(left, withPhase); out.put("\nR:"); out.putRows(right, withPhase); out.put('\n');
+}
+
+// Items added from the editor carry the live phases, so only `convert` (copying stored phases over) writes them.
+void formatPlaylistText(TextWriter& out, const std::vector<PlaylistItem>& items, bool withPhase, std::atomic<float>* progress) {
+    out.clear();
+    for (size_t i = 0; i < items.size(); i++) {
+        const PlaylistItem& item = items[i];
+        if (progress && (i & 1023) == 0) progress->store((float)i / items.size(), std::memory_order_relaxed);
+        out.put("ITEM\nDURATION: "); out.putNumber(item.duration);
+        out.put("\nL:"); out.putRows(item.preset.freqsL, withPhase); out.put("\nR:"); out.putRows(item.preset.freqsR, withPhase); out.put('\n');
+    }
+}
+
+bool hasExtension(const std::string& path, const char* extension) {
+    size_t n = std::strlen(extension);
+    if (path.size() < n) return false;
+    for (size_t i = 0; i < n; i++) if (tolower((unsigned char)path[path.size() - n + i]) != extension[i]) return false;
+    return true;
+}
+
+bool writePresetBinary(const std::string& path, const std::vector<PlaylistItem>& items, bool singleWave) {
+    uint64_t rowCount = 0;
+    for (const auto& item : items) rowCount += item.preset.freqsL.size() + item.preset.freqsR.size();
+    LsjbHeader header = { { 'L', 'S', 'J', 'B' }, LSJB_VERSION, (uint32_t)items.size(), singleWave ? LSJB_SINGLE_WAVE : 0u, rowCount, 0, 0, 0, 0, 0 };
+    auto align8 = [](uint64_t offset) { return (offset + 7) & ~(uint64_t)7; };
+    header.indexOffset = sizeof(LsjbHeader);
+    header.phaseOffset = align8(header.indexOffset + items.size() * sizeof(LsjbItem));
+    header.freqOffset = header.phaseOffset + rowCount * sizeof(double);
+    header.typeOffset = header.freqOffset + rowCount * sizeof(float);
+    header.muteOffset = header.typeOffset + rowCount;
+    std::vector<unsigned char> file((size_t)(header.muteOffset + rowCount), 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    LsjbItem* index = (LsjbItem*)(file.data() + header.indexOffset);
+    double* phase = (double*)(file.data() + header.phaseOffset); float* freq = (float*)(file.data() + header.freqOffset);
+    unsigned char* type = file.data() + header.typeOffset; unsigned char* mute = file.data() + header.muteOffset;
+    uint64_t row = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        const WavePreset& preset = items[i].preset;
+        index[i] = { row, (uint32_t)preset.freqsL.size(), (uint32_t)preset.freqsR.size(), items[i].duration, 0 };
+        for (auto* rows : { &preset.freqsL, &preset.freqsR })
+            for (const auto& r : *rows) { phase[row] = r.phase; freq[row] = r.freq; type[row] = (unsigned char)r.type; mute[row] = r.muted ? 1 : 0; row++; }
+    }
+    FILE* out = std::fopen(path.c_str(), "wb"); if (!out) return false;
+    bool ok = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+    return std::fclose(out) == 0 && ok;
+}
+
+// Validates every offset against the mapped size, then copies rows straight out of the packed arrays.
+bool readPresetBinary(const std::string& path, std::vector<PlaylistItem>& items, bool& singleWave, std::string& error, std::atomic<float>* progress) {
+    MappedFile file; LsjbHeader header;
+    if (!file.open(path)) { error = "cannot open file"; return false; }
+    if (!validatePresetBinary(file, header, error)) return false;
+    singleWave = (header.flags & LSJB_SINGLE_WAVE) != 0;
+    items.clear(); items.resize(header.itemCount);
+    for (uint32_t i = 0; i < header.itemCount; i++) {
+        if (!decodePresetBinaryItem(file, header, i, items[i], error)) return false;
+        if (progress && (i & 1023) == 0) progress->store((float)i / header.itemCount, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+// Checks the header and that every array lies inside the mapped file.
+bool validatePresetBinary(const MappedFile& file, LsjbHeader& header, std::string& error) {
+    if (file.size < sizeof(header)) { error = "file is too short"; return false; }
+    std::memcpy(&header, file.data, sizeof(header));
+    if (std::memcmp(header.magic, "LSJB", 4) != 0) { error = "not an .lsjb file"; return false; }
+    if (header.version != LSJB_VERSION) { error = "unsupported .lsjb version " + std::to_string(header.version); return false; }
+    // Each array is checked as offset <= size && count * elemSize <= size - offset, so a crafted offset cannot wrap around.
+    uint64_t rows = header.rowCount, size = file.size;
+    auto fits = [size](uint64_t offset, uint64_t count, uint64_t elemSize) { return offset <= size && count <= size / elemSize && count * elemSize <= size - offset; };
+    if (!fits(header.indexOffset, header.itemCount, sizeof(LsjbItem)) || !fits(header.phaseOffset, rows, sizeof(double))
+        || !fits(header.freqOffset, rows, sizeof(float)) || !fits(header.typeOffset, rows, 1) || !fits(header.muteOffset, rows, 1)) { error = "file is truncated"; return false; }
+    return true;
+}
+
+// Copies one item's rows straight out of the packed arrays.
+bool decodePresetBinaryItem(const MappedFile& file, const LsjbHeader& header, uint32_t index, PlaylistItem& item, std::string& error) {
+    const unsigned char* phase = file.data + header.phaseOffset; const unsigned char* freq = file.data + header.freqOffset;
+    const unsigned char* type = file.data + header.typeOffset; const unsigned char* mute = file.data + header.muteOffset;
+    uint64_t rows = header.rowCount;
+    LsjbItem entry; std::memcpy(&entry, file.data + header.indexOffset + (uint64_t)index * sizeof(LsjbItem), sizeof(entry));
+    if (entry.firstRow > rows || (uint64_t)entry.countL + entry.countR > rows - entry.firstRow) { error = "item " + std::to_string(index) + " points outside the row arrays"; return false; }
+    item.duration = entry.duration;
+    uint64_t row = entry.firstRow;
+    for (auto* target : { &item.preset.freqsL, &item.preset.freqsR }) {
+        uint32_t count = target == &item.preset.freqsL ? entry.countL : entry.countR;
+        target->clear(); target->reserve(count);
+        for (uint32_t k = 0; k < count; k++, row++) {
+            float f; std::memcpy(&f, freq + row * sizeof(float), sizeof(f));
+            FrequencyRow r(f); std::memcpy(&r.phase, phase + row * sizeof(double), sizeof(double));
+            r.type = type[row] <= SAWTOOTH ? (WaveType)type[row] : SINE; r.muted = mute[row] != 0;
+            target->push_back(r);
+        }
+    }
+    return true;
+}
+
+bool openStreamingPlaylist(AudioState& state, const std::string& path) {
+    state.stream.reset();
+    std::unique_ptr<StreamingPlaylist> stream(new StreamingPlaylist());
+    StreamingPlaylist& s = *stream; s.path = path; s.binary = hasExtension(path, ".lsjb");
+    std::string error;
+    if (!s.file.open(path)) { state.parseErrorMsg = path + ": cannot open file"; return false; }
+    if (s.binary && !validatePresetBinary(s.file, s.header, error)) { state.parseErrorMsg = path + ": " + error; return false; }
+    if (!s.binary) {
+        s.indexer = std::thread([&s] {
+            std::vector<uint64_t> batch; const char* text = (const char*)s.file.data; size_t size = s.file.size;
+            for (size_t pos = 0; pos < size;) {
+                if (size - pos >= 4 && std::memcmp(text + pos, "ITEM", 4) == 0) batch.push_back(pos);
+                const char* newline = (const char*)std::memchr(text + pos, '\n', size - pos);
+                pos = newline ? (size_t)(newline - text) + 1 : size;
+                if (batch.size() == 1024 || pos == size) {
+                    std::lock_guard<std::mutex> lock(s.mutex);
+                    if (s.stopping) return;
+                    s.offsets.insert(s.offsets.end(), batch.begin(), batch.end()); batch.clear();
+                    if (pos == size) s.indexDone = true;
+                    s.cv.notify_all();
+                }
+            }
+            std::lock_guard<std::mutex> lock(s.mutex); s.indexDone = true; s.cv.notify_all();
+        });
+    }
+    s.prefetcher = std::thread([&s] {
+        std::unique_lock<std::mutex> lock(s.mutex);
+        while (!s.stopping) {
+            for (auto it = s.window.begin(); it != s.window.end() && it->first < s.playHead;) it = s.window.erase(it);
+            size_t next = s.playHead, available = s.available();
+            while (next < s.playHead + STREAM_WINDOW && next < available && s.window.count(next)) next++;
+            if (next >= s.playHead + STREAM_WINDOW || next >= available) { s.cv.wait(lock); continue; }
+            uint64_t begin = s.binary ? 0 : s.offsets[next], end = s.binary ? 0 : (next + 1 < s.offsets.size() ? s.offsets[next + 1] : s.file.size);
+            lock.unlock();
+            // Items that fail to decode become empty zero-length items, so playback just skips them.
+            PlaylistItem item; item.duration = 0.0f; std::string error;
+            if (s.binary) { if (!decodePresetBinaryItem(s.file, s.header, (uint32_t)next, item, error)) { item = PlaylistItem(); item.duration = 0.0f; } }
+            else {
+                std::vector<PlaylistItem> parsed; ParseError parseError;
+                if (!parsePlaylistFile(std::string_view((const char*)s.file.data + begin, (size_t)(end - begin)), parsed, parseError)) error = formatParseError("item " + std::to_string(next), parseError);
+                else if (!parsed.empty()) item = std::move(parsed[0]);
             }
+            lock.lock();
+            if (!error.empty() && s.error.empty()) s.error = error;
+            if (next >= s.playHead) s.window.emplace(next, std::move(item));
         }
+    });
+    state.stream = std::move(stream);
+    state.parseErrorMsg.clear();
+    return true;
+}
+
+// Starts playlist item `index`, from the stream's decoded window when streaming. Returns false if it is not ready yet.
+bool beginPlaylistItem(AudioState& state, int index) {
+    if (!state.stream) {
+        loadPlaylistItem(state, index);
+        state.playlistTimer = state.playlist[index].duration;
+        return true;
     }
-    state.currentWaveFile = path; state.waveDataIsDirty = true;
+    PlaylistItem item;
+    if (!state.stream->take((size_t)index, item)) return false;
+    publishBank(state, std::move(item.preset));
+    state.playlistTimer = item.duration;
+    return true;
 }
 
-void savePlaylistToFile(const std::string& path, AudioState& state) {
-    std::ofstream file(path); if (!file.is_open()) return;
-    for (const auto& item : state.playlist) {
-        file << "ITEM\n";
-        file << "DURATION: " << item.duration << "\n";
-        file << "L:";
-        for (size_t i = 0; i < item.preset.freqsL.size(); ++i) { file << formatRowToString(item.preset.freqsL[i]) << (i < item.preset.freqsL.size() - 1 ? "," : ""); }
-        file << "\n";
-        file << "R:";
-        for (size_t i = 0; i < item.preset.freqsR.size(); ++i) { file << formatRowToString(item.preset.freqsR[i]) << (i < item.preset.freqsR.size() - 1 ? "," : ""); }
-        file << "\n";
+bool playlistEndsBefore(AudioState& state, int index) {
+    if (!state.stream) return index >= (int)state.playlist.size();
+    std::lock_guard<std::mutex> lock(state.stream->mutex);
+    return (state.stream->binary || state.stream->indexDone) && (size_t)index >= state.stream->available();
+}
+
+// LissGen convert <input> <output>: any of .lsj, .lsjp and .lsjb to any other, chosen by extension.
+int runConvertCommand(int argc, char* argv[]) {
+    if (argc != 4) { fprintf(stderr, "usage: %s convert <input.lsj|.lsjp|.lsjb> <output.lsj|.lsjp|.lsjb>\n", argv[0]); return 1; }
+    std::string input = argv[2], output = argv[3], error;
+    std::vector<PlaylistItem> items; bool singleWave = true;
+    if (hasExtension(input, ".lsjb")) { if (!readPresetBinary(input, items, singleWave, error)) error = input + ": " + error; }
+    else {
+        std::string text; ParseError parseError;
+        if (!readFileToString(input, text)) error = input + ": cannot open file";
+        else if (hasExtension(input, ".lsjp")) { singleWave = false; if (!parsePlaylistFile(text, items, parseError)) error = formatParseError(input, parseError); }
+        else { items.resize(1); if (!parseWaveFile(text, items[0].preset, parseError)) error = formatParseError(input, parseError); }
+    }
+    if (!error.empty()) { fprintf(stderr, "%s\n", error.c_str()); return 1; }
+    TextWriter out; bool ok;
+    if (hasExtension(output, ".lsjb")) ok = writePresetBinary(output, items, singleWave);
+    else if (hasExtension(output, ".lsjp")) { formatPlaylistText(out, items, true); ok = writeFileFromBuffer(output, out); }
+    else {
+        if (items.size() != 1) { fprintf(stderr, "%s holds %zu items; only a single wave can be written as .lsj\n", input.c_str(), items.size()); return 1; }
+        formatWaveText(out, items[0].preset.freqsL, items[0].preset.freqsR, true); ok = writeFileFromBuffer(output, out);
     }
-    state.currentPlaylistFile = path;
+    if (!ok) { fprintf(stderr, "cannot write %s\n", output.c_str()); return 1; }
+    printf("%zu item(s) written to %s\n", items.size(), output.c_str());
+    return 0;
+}
+
+bool readPlaylistItems(const std::string& path, std::vector<PlaylistItem>& items, std::string& error, std::atomic<float>* progress) {
+    if (hasExtension(path, ".lsjb")) {
+        bool singleWave;
+        if (!readPresetBinary(path, items, singleWave, error, progress)) { error = path + ": " + error; return false; }
+        return true;
+    }
+    std::string text; if (!readFileToString(path, text)) { error = path + ": cannot open file"; return false; }
+    ParseError parseError;
+    if (!parsePlaylistFile(text, items, parseError, progress)) { error = formatParseError(path, parseError); return false; }
+    return true;
 }
 
 void loadPlaylistFromFile(const std::string& path, AudioState& state) {
-    std::ifstream file(path); if (!file.is_open()) return;
-    state.playlist.clear();
-    std::string line;
-    PlaylistItem currentItem;
-    bool itemInProgress = false;
-    auto finalizeItem = [&](PlaylistItem& item) {
-        if (!item.preset.freqsL.empty() || !item.preset.freqsR.empty()) {
-            state.playlist.push_back(item);
+    std::vector<PlaylistItem> items;
+    if (!readPlaylistItems(path, items, state.parseErrorMsg)) return;
+    state.playlist = std::move(items);
+    state.parseErrorMsg.clear(); state.currentPlaylistFile = path;
+}
+
+// Hands `bank` to the audio engine, which swaps it in whole between two blocks. With `keepPhases` the rows keep
+// running from the live oscillators' phases instead of the stored ones, so an edit does not restart the sound.
+// Caller holds bankMutex.
+void publishBank(AudioState& state, WavePreset&& bank, bool keepPhases) {
+    state.pendingBank = std::move(bank);
+    state.pendingKeepsPhase = keepPhases;
+    state.bankReady.store(true, std::memory_order_release);
+}
+
+// Swaps the published bank with the live channels; the old rows stay in pendingBank and are freed by the next
+// publish, never on the audio thread. Caller holds bankMutex.
+bool adoptPendingBank(AudioState& state) {
+    if (!state.bankReady.load(std::memory_order_acquire)) return false;
+    if (state.pendingKeepsPhase) {
+        for (size_t k = 0; k < state.pendingBank.freqsL.size() && k < state.channelL.size(); k++) state.pendingBank.freqsL[k].phase = state.channelL[k].phase;
+        for (size_t k = 0; k < state.pendingBank.freqsR.size() && k < state.channelR.size(); k++) state.pendingBank.freqsR[k].phase = state.channelR[k].phase;
+    }
+    std::swap(state.channelL, state.pendingBank.freqsL); std::swap(state.channelR, state.pendingBank.freqsR);
+    state.bankReady.store(false, std::memory_order_relaxed);
+    state.bankAdopted.store(true, std::memory_order_release);
+    return true;
+}
+
+// Queues a job on the I/O thread unless one is already running.
+bool startIoJob(AudioState& state, const char* status, std::function<void()> work) {
+    if (state.io.busy.exchange(true)) return false;
+    state.io.progress = 0.0f; state.io.status = status;
+    state.io.pool.submit([&state, work] { work(); state.io.busy = false; });
+    return true;
+}
+
+void postIoCompletion(AudioState& state, std::function<void(AudioState&)> done) {
+    std::lock_guard<std::mutex> lock(state.io.mutex); state.io.completions.push_back(std::move(done));
+}
+
+void applyIoCompletions(AudioState& state) {
+    std::vector<std::function<void(AudioState&)>> done;
+    { std::lock_guard<std::mutex> lock(state.io.mutex); done.swap(state.io.completions); }
+    for (auto& apply : done) apply(state);
+}
+
+void drawIoProgress(AudioState& state) {
+    if (!state.io.busy) return;
+    ImGui::ProgressBar(state.io.progress.load(std::memory_order_relaxed), ImVec2(-FLT_MIN, 0.0f), state.io.status);
+}
+
+// Save dialogs start on the current file name; all of them open in the folder last picked.
+void openPresetDialog(AudioState& state, const char* key, const char* title, const char* filters, const std::string& fileName) {
+    IGFD::FileDialogConfig config; config.path = state.presetDir;
+    if (!fileName.empty()) { config.fileName = fileName.substr(fileName.find_last_of("/\\") + 1); config.flags = ImGuiFileDialogFlags_ConfirmOverwrite; }
+    ImGuiFileDialog::Instance()->OpenDialog(key, title, filters, config);
+}
+
+// The dialog lists the folder on its own scan thread; the picked file is then read or written on the I/O thread.
+// Save jobs get a copy of the banks taken here, since the UI keeps editing them while the job runs.
+void drawFileDialogs(AudioState& state) {
+    ImGuiFileDialog* dialog = ImGuiFileDialog::Instance();
+    std::string key = dialog->GetOpenedKey();
+    if (key.empty() || !dialog->Display(key, ImGuiWindowFlags_NoCollapse, ImVec2(600, 400), ImGui::GetIO().DisplaySize)) return;
+    if (dialog->IsOk()) {
+        std::string path = dialog->GetFilePathName(); state.presetDir = dialog->GetCurrentPath();
+        bool started = true;
+        if (key == "SaveWave") {
+            auto bank = std::make_shared<WavePreset>(); bank->freqsL = state.channelL; bank->freqsR = state.channelR;
+            started = startIoJob(state, "Saving wave", [&state, path, bank] { saveWaveJob(state, path, *bank); });
         }
+        else if (key == "LoadWave") started = startIoJob(state, "Loading wave", [&state, path] { loadWaveJob(state, path); });
+        else if (key == "SavePlaylist") {
+            auto items = std::make_shared<std::vector<PlaylistItem>>(state.playlist);
+            started = startIoJob(state, "Saving playlist", [&state, path, items] { savePlaylistJob(state, path, *items); });
+        }
+        else if (key == "LoadPlaylist") started = startIoJob(state, "Loading playlist", [&state, path] { loadPlaylistJob(state, path); });
+        else if (key == "StreamPlaylist" && openStreamingPlaylist(state, path)) { state.playlistPlaying = false; state.currentPlaylistItem = -1; }
+        if (!started) state.parseErrorMsg = "Another file is still being read or written.";
+    }
+    dialog->Close();
+}
+
+void loadWaveJob(AudioState& state, const std::string& path) {
+    WavePreset bank; std::string error;
+    bool ok = readWaveBank(path, bank, error);
+    if (ok) { std::lock_guard<std::mutex> lock(state.bankMutex); publishBank(state, std::move(bank)); }
+    postIoCompletion(state, [path, ok, error](AudioState& s) { if (ok) { s.currentWaveFile = path; s.parseErrorMsg.clear(); } else s.parseErrorMsg = error; });
+}
+
+// Our own saves update the watched stamp, so they are not reloaded over edits made since.
+void saveWaveJob(AudioState& state, const std::string& path, const WavePreset& bank) {
+    bool ok = writeWaveBank(path, bank, state.io.writer);
+    postIoCompletion(state, [path, ok](AudioState& s) { if (ok) { s.currentWaveFile = path; rememberFileStamp(s.watcher, path); } else s.parseErrorMsg = path + ": cannot write file"; });
+}
+
+// A reload also republishes the item playing, so the change is heard without waiting for the next one.
+void loadPlaylistJob(AudioState& state, const std::string& path, bool reload) {
+    auto items = std::make_shared<std::vector<PlaylistItem>>(); std::string error;
+    bool ok = readPlaylistItems(path, *items, error, &state.io.progress);
+    postIoCompletion(state, [path, ok, error, items, reload](AudioState& s) {
+        if (!ok) { s.parseErrorMsg = error; return; }
+        // A reload while playing republishes the current item only if its rows changed, keeping the live phases and
+        // the item's timer, so saving from an external script does not restart the sound.
+        int current = s.currentPlaylistItem;
+        bool playing = reload && s.playlistPlaying && current >= 0 && current < (int)s.playlist.size() && current < (int)items->size();
+        auto sameRows = [](const std::vector<FrequencyRow>& a, const std::vector<FrequencyRow>& b) {
+            if (a.size() != b.size()) return false;
+            for (size_t k = 0; k < a.size(); k++) if (a[k].freq != b[k].freq || a[k].type != b[k].type || a[k].muted != b[k].muted) return false;
+            return true;
         };
-    while (std::getline(file, line)) {
-        if (line.rfind("ITEM", 0) == 0) {
-            if (itemInProgress) finalizeItem(currentItem);
-            currentItem = PlaylistItem();
-            itemInProgress = true;
+        bool changed = playing && !(sameRows(s.playlist[current].preset.freqsL, (*items)[current].preset.freqsL) && sameRows(s.playlist[current].preset.freqsR, (*items)[current].preset.freqsR));
+        s.playlist = std::move(*items); s.currentPlaylistFile = path; s.parseErrorMsg.clear();
+        if (!reload) { s.playlistView.selected.clear(); s.playlistView.anchor = -1; }
+        if (s.currentPlaylistItem >= (int)s.playlist.size()) s.currentPlaylistItem = -1;
+        else if (changed) publishBank(s, WavePreset(s.playlist[current].preset), true);
+    });
+}
+
+void savePlaylistJob(AudioState& state, const std::string& path, const std::vector<PlaylistItem>& items) {
+    bool ok = writePlaylistItems(path, items, state.io.writer, &state.io.progress);
+    postIoCompletion(state, [path, ok](AudioState& s) { if (ok) { s.currentPlaylistFile = path; rememberFileStamp(s.watcher, path); } else s.parseErrorMsg = path + ": cannot write file"; });
+}
+
+FileStamp readFileStamp(const std::string& path) {
+    FileStamp stamp; std::error_code ec;
+    stamp.time = std::filesystem::last_write_time(path, ec); if (ec) return FileStamp();
+    stamp.size = std::filesystem::file_size(path, ec); if (ec) return FileStamp();
+    stamp.exists = true;
+    return stamp;
+}
+
+// Called every frame by the UI; only a new path costs a stat, and the first one starts the thread.
+void setWatchedFile(FileWatcher& watcher, int target, const std::string& path) {
+    std::lock_guard<std::mutex> lock(watcher.mutex);
+    FileWatcher::Target& t = watcher.targets[target];
+    if (t.path == path) return;
+    t.path = path; t.stamp = path.empty() ? FileStamp() : readFileStamp(path);
+    t.active = t.stamp.exists; t.changedAt = 0;
+    watcher.generation++;
+    if (t.active && !watcher.thread.joinable()) watcher.thread = std::thread(runFileWatcher, std::ref(watcher));
+}
+
+void rememberFileStamp(FileWatcher& watcher, const std::string& path) {
+    FileStamp stamp = readFileStamp(path);
+    std::lock_guard<std::mutex> lock(watcher.mutex);
+    for (FileWatcher::Target& t : watcher.targets) {
+        if (t.path != path) continue;
+        t.stamp = stamp; t.changedAt = 0;
+        if (!t.active && stamp.exists) { t.active = true; watcher.generation++; }  // a placeholder name saved for the first time
+    }
+    if (stamp.exists && !watcher.thread.joinable() && std::any_of(std::begin(watcher.targets), std::end(watcher.targets), [](const FileWatcher::Target& t) { return t.active; }))
+        watcher.thread = std::thread(runFileWatcher, std::ref(watcher));
+}
+
+// Watches the folders rather than the files, since scripts and editors often replace a file by renaming a new one
+// over it. Any event only triggers a stamp check, which also filters out the other files of the folder.
+void runFileWatcher(FileWatcher& watcher) {
+    unsigned armed = ~0u;
+#ifdef _WIN32
+    std::vector<HANDLE> handles;
+#elif defined(__linux__)
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    std::vector<int> watches;
+#endif
+    while (true) {
+        std::vector<std::string> dirs; bool rearm = false;
+        {
+            std::lock_guard<std::mutex> lock(watcher.mutex);
+            if (watcher.stopping) break;
+            if (watcher.generation != armed) {
+                armed = watcher.generation; rearm = true;
+                for (const FileWatcher::Target& t : watcher.targets) {
+                    if (!t.active) continue;
+                    std::string dir = std::filesystem::path(t.path).parent_path().string(); if (dir.empty()) dir = ".";
+                    if (std::find(dirs.begin(), dirs.end(), dir) == dirs.end()) dirs.push_back(dir);
+                }
+            }
+        }
+        bool signaled = false;
+#ifdef _WIN32
+        if (rearm) {
+            for (HANDLE h : handles) FindCloseChangeNotification(h);
+            handles.clear();
+            for (const std::string& dir : dirs) {
+                HANDLE h = FindFirstChangeNotificationW(std::filesystem::path(dir).wstring().c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+                if (h != INVALID_HANDLE_VALUE) handles.push_back(h);
+            }
         }
-        else if (line.rfind("DURATION:", 0) == 0) {
-            try { currentItem.duration = std::stof(line.substr(10)); }
-            catch (...) {}
+        if (handles.empty()) { Sleep(HOT_RELOAD_WAIT_MS); signaled = true; }
+        else {
+            DWORD result = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, HOT_RELOAD_WAIT_MS);
+            if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + handles.size()) { signaled = true; FindNextChangeNotification(handles[result - WAIT_OBJECT_0]); }
         }
+#elif defined(__linux__)
+        if (rearm && fd >= 0) {
+            for (int wd : watches) inotify_rm_watch(fd, wd);
+            watches.clear();
+            for (const std::string& dir : dirs) {
+                int wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+                if (wd >= 0) watches.push_back(wd);
+            }
+        }
+        if (fd < 0) { std::this_thread::sleep_for(std::chrono::milliseconds(HOT_RELOAD_WAIT_MS)); signaled = true; }
         else {
-            std::vector<FrequencyRow>* targetChannel = nullptr;
-            std::string data;
-            if (line.rfind("L:", 0) == 0) { targetChannel = &currentItem.preset.freqsL; data = line.substr(2); }
-            else if (line.rfind("R:", 0) == 0) { targetChannel = &currentItem.preset.freqsR; data = line.substr(2); }
-            if (targetChannel) {
-                std::stringstream ss(data); std::string token;
-                while (std::getline(ss, token, ',')) {
-                    if (token.empty()) continue;
-                    try { targetChannel->push_back(parseRowFromString(token)); }
-                    catch (...) {}
+            pollfd pfd = { fd, POLLIN, 0 };
+            if (poll(&pfd, 1, HOT_RELOAD_WAIT_MS) > 0) {
+                signaled = true;
+                alignas(inotify_event) char buffer[4096];
+                while (read(fd, buffer, sizeof(buffer)) > 0) {}
+            }
+        }
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(HOT_RELOAD_WAIT_MS)); signaled = true;
+#endif
+        if (!signaled) continue;
+        for (int i = 0; i < WATCH_COUNT; i++) {
+            std::string path;
+            { std::lock_guard<std::mutex> lock(watcher.mutex); if (watcher.targets[i].active) path = watcher.targets[i].path; }
+            if (path.empty()) continue;
+            FileStamp stamp = readFileStamp(path);
+            std::lock_guard<std::mutex> lock(watcher.mutex);
+            FileWatcher::Target& t = watcher.targets[i];
+            if (t.path == path && stamp != t.stamp) { t.stamp = stamp; t.changedAt = std::max<Uint32>(SDL_GetTicks(), 1); }
+        }
+    }
+#ifdef _WIN32
+    for (HANDLE h : handles) FindCloseChangeNotification(h);
+#elif defined(__linux__)
+    if (fd >= 0) close(fd);
+#endif
+}
+
+// Reloads run on the I/O thread like any load: a wave is published between two audio blocks, and a file that fails to
+// parse only sets parseErrorMsg while the previous bank keeps playing. A pending reload waits for a busy I/O thread.
+void pollHotReload(AudioState& state) {
+    setWatchedFile(state.watcher, WATCH_WAVE, state.hotReload ? state.currentWaveFile : std::string());
+    setWatchedFile(state.watcher, WATCH_PLAYLIST, state.hotReload && !state.stream ? state.currentPlaylistFile : std::string());
+    if (!state.hotReload || state.io.busy) return;
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < WATCH_COUNT; i++) {
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(state.watcher.mutex);
+            FileWatcher::Target& t = state.watcher.targets[i];
+            if (!t.changedAt || !t.stamp.exists || now - t.changedAt < HOT_RELOAD_DEBOUNCE_MS) continue;
+            t.changedAt = 0; path = t.path;
+        }
+        if (i == WATCH_WAVE) startIoJob(state, "Reloading wave", [&state, path] { loadWaveJob(state, path); });
+        else startIoJob(state, "Reloading playlist", [&state, path] { loadPlaylistJob(state, path, true); });
+        return;
+    }
+}
+
+// Only the rows inside the visible scroll range submit widgets, so a bank of thousands of oscillators
+// costs the same per frame as a handful. Reorder, duplicate and delete are applied after the clipper
+// finishes, and the row being dragged is kept alive even when it scrolls out of view.
+void drawFrequencyRows(AudioState& state, std::vector<FrequencyRow>& rows, char channel) {
+    int moveFrom = -1, moveTo = -1, duplicateRow = -1, removeRow = -1;
+    const ImGuiPayload* dragging = ImGui::GetDragDropPayload();
+    int dragRow = -1;
+    if (dragging && dragging->IsDataType("FREQ_ROW")) {
+        const DragPayload& payload_n = *(const DragPayload*)dragging->Data;
+        if (payload_n.sourceChannel == channel && payload_n.sourceIndex < (int)rows.size()) dragRow = payload_n.sourceIndex;
+    }
+    ImGui::PushID(channel);
+    ImGuiListClipper clipper;
+    clipper.Begin((int)rows.size(), ImGui::GetFrameHeightWithSpacing());
+    if (dragRow >= 0) clipper.IncludeItemByIndex(dragRow);
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            FrequencyRow& row = rows[i];
+            ImGui::PushID(i);
+            ImGui::Button(":::");
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Drag to reorder in the same channel.\nDrag to the other channel's header to move.\nHold SHIFT while dropping to clone.");
+            if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
+                DragPayload payload_data = { i, channel };
+                ImGui::SetDragDropPayload("FREQ_ROW", &payload_data, sizeof(DragPayload));
+                ImGui::Text("Move %.2f Hz (%c)", row.freq, "SQW"[(int)row.type]);
+                ImGui::EndDragDropSource();
+            }
+            if (ImGui::BeginDragDropTarget()) {
+                if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("FREQ_ROW")) {
+                    const DragPayload& payload_n = *(const DragPayload*)payload->Data;
+                    if (payload_n.sourceChannel == channel && payload_n.sourceIndex != i) { moveFrom = payload_n.sourceIndex; moveTo = i; }
                 }
+                ImGui::EndDragDropTarget();
             }
+            ImGui::SameLine(); ImGui::SetNextItemWidth(80);
+            if (ImGui::InputFloat("Hz", &row.freq, 0.0f, 0.0f, "%.3f")) state.waveDataIsDirty = true;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Frequency in Hertz for this oscillator.");
+            ImGui::SameLine();
+            if (ImGui::Button("+")) { row.freq += getStep(state.shiftPressed, state.ctrlPressed); state.waveDataIsDirty = true; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Increase frequency by the Step value.\nHold Shift or Ctrl+Shift for fine tuning.");
+            ImGui::SameLine();
+            if (ImGui::Button("-")) { row.freq -= getStep(state.shiftPressed, state.ctrlPressed); state.waveDataIsDirty = true; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Decrease frequency by the Step value.\nHold Shift or Ctrl+Shift for fine tuning.");
+            ImGui::SameLine();
+            if (ImGui::Button("x2")) { row.freq *= 2.0f; state.waveDataIsDirty = true; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Multiply frequency by 2 (goes up one octave).");
+            ImGui::SameLine();
+            if (ImGui::Button("/2")) { row.freq /= 2.0f; state.waveDataIsDirty = true; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Divide frequency by 2 (goes down one octave).");
+            ImGui::SameLine();
+            bool isSine = row.type == SINE;
+            if (isSine) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.2f, 1.0f));
+            if (ImGui::Button("S")) { row.type = SINE; state.waveDataIsDirty = true; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Sine.");
+            if (isSine) ImGui::PopStyleColor();
+            ImGui::SameLine(0, 2);
+            bool isSquare = row.type == SQUARE;
+            if (isSquare) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
+            if (ImGui::Button("Q")) { row.type = SQUARE; state.waveDataIsDirty = true; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Square.");
+            if (isSquare) ImGui::PopStyleColor();
+            ImGui::SameLine(0, 2);
+            bool isSaw = row.type == SAWTOOTH;
+            if (isSaw) ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.6f, 1.0f));
+            if (ImGui::Button("W")) { row.type = SAWTOOTH; state.waveDataIsDirty = true; }
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Set waveform to Sawtooth.");
+            if (isSaw) ImGui::PopStyleColor();
+            ImGui::SameLine();
+            if (ImGui::Checkbox("M", &row.muted)) state.waveDataIsDirty = true;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Mute only this frequency.");
+            ImGui::SameLine();
+            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(50 / 255.0f, 130 / 255.0f, 0 / 255.0f, 1.0f));
+            if (ImGui::Button("D")) duplicateRow = i;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Duplicate this frequency row.");
+            ImGui::PopStyleColor();
+            ImGui::SameLine();
+            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
+            if (ImGui::Button("X")) removeRow = i;
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("Remove this frequency row.");
+            ImGui::PopStyleColor();
+            ImGui::PopID();
+        }
+    }
+    clipper.End();
+    ImGui::PopID();
+
+    if (moveFrom >= 0 && moveFrom < (int)rows.size()) {
+        FrequencyRow temp = rows[moveFrom];
+        rows.erase(rows.begin() + moveFrom);
+        rows.insert(rows.begin() + moveTo, temp);
+        state.waveDataIsDirty = true;
+    }
+    else if (duplicateRow >= 0) { rows.insert(rows.begin() + duplicateRow + 1, rows[duplicateRow]); state.waveDataIsDirty = true; }
+    else if (removeRow >= 0) { rows.erase(rows.begin() + removeRow); state.waveDataIsDirty = true; }
+}
+
+// The table only submits the rows inside its scroll range, so a generated playlist of 10k+ items edits at full
+// frame rate. Click selects, Ctrl+click toggles, Shift+click extends from the last clicked row; the buttons above
+// the table act on the whole selection. Double-click loads an item into the editor, or jumps to it while playing.
+void drawPlaylistTable(AudioState& state) {
+    PlaylistView& view = state.playlistView;
+    std::vector<PlaylistItem>& items = state.playlist;
+    int count = (int)items.size();
+    view.selected.resize(items.size(), 0);
+    if (view.anchor >= count) view.anchor = -1;
+    int selectedCount = (int)std::count(view.selected.begin(), view.selected.end(), 1);
+    std::vector<int> order;
+    std::vector<char> selected;
+    bool reorder = false;
+
+    if (ImGui::Button("All")) std::fill(view.selected.begin(), view.selected.end(), 1);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Select every item.");
+    ImGui::SameLine();
+    if (ImGui::Button("None")) std::fill(view.selected.begin(), view.selected.end(), 0);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Clear the selection.");
+    ImGui::SameLine();
+    ImGui::Text("%d of %d selected", selectedCount, count);
+    ImGui::SameLine();
+    ImGui::Checkbox("Follow", &view.followPlaying);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Scroll to the item being played.");
+
+    ImGui::BeginDisabled(selectedCount == 0);
+    if (ImGui::Button("Up")) {
+        reorder = true;
+        for (int i = 0; i < count; i++) order.push_back(i);
+        selected = view.selected;
+        for (int i = 1; i < count; i++) if (selected[i] && !selected[i - 1]) { std::swap(order[i], order[i - 1]); std::swap(selected[i], selected[i - 1]); }
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Move the selected items up one place.");
+    ImGui::SameLine();
+    if (ImGui::Button("Down")) {
+        reorder = true;
+        for (int i = 0; i < count; i++) order.push_back(i);
+        selected = view.selected;
+        for (int i = count - 2; i >= 0; i--) if (selected[i] && !selected[i + 1]) { std::swap(order[i], order[i + 1]); std::swap(selected[i], selected[i + 1]); }
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Move the selected items down one place.");
+    ImGui::SameLine();
+    if (ImGui::Button("Duplicate")) {
+        reorder = true;
+        for (int i = 0; i < count; i++) {
+            order.push_back(i); selected.push_back(0);
+            if (view.selected[i]) { order.push_back(i); selected.push_back(1); }
+        }
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Insert a copy after each selected item; the copies become the selection.");
+    ImGui::SameLine();
+    if (ImGui::Button("Remove")) {
+        reorder = true;
+        for (int i = 0; i < count; i++) if (!view.selected[i]) { order.push_back(i); selected.push_back(0); }
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Remove the selected items from the playlist.");
+    ImGui::SameLine();
+    if (ImGui::Button("Set Duration")) {
+        for (int i = 0; i < count; i++) if (view.selected[i]) items[i].duration = view.duration;
+    }
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Give every selected item the duration on the right.");
+    ImGui::SameLine(); ImGui::SetNextItemWidth(120);
+    ImGui::SliderFloat("##SetDuration", &view.duration, 0.1f, 60.0f, "%.2f s");
+    ImGui::EndDisabled();
+
+    int playing = state.playlistPlaying ? state.currentPlaylistItem : -1;
+    bool scrollToPlaying = view.followPlaying && playing >= 0 && playing < count && playing != view.scrolledTo;
+    float rowHeight = ImGui::GetFrameHeightWithSpacing();
+    float tableHeight = rowHeight * (float)(std::min(std::max(count, 1), PLAYLIST_VISIBLE_ROWS) + 1);
+    ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit;
+    int clicked = -1, activated = -1;
+    if (ImGui::BeginTable("PlaylistTable", 4, flags, ImVec2(0.0f, tableHeight))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Item", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+        ImGui::TableSetupColumn("Duration", ImGuiTableColumnFlags_WidthFixed, 140.0f);
+        ImGui::TableSetupColumn("Left", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+        ImGui::TableSetupColumn("Right", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(count, rowHeight);
+        if (scrollToPlaying) clipper.IncludeItemByIndex(playing);
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                PlaylistItem& item = items[i];
+                ImGui::PushID(i);
+                ImGui::TableNextRow(0, rowHeight);
+                ImGui::TableNextColumn();
+                // The playing row gets its own background, so the selection highlight still shows what the buttons act on.
+                bool isCurrent = i == playing;
+                if (isCurrent) ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImVec4(0.2f, 0.45f, 0.25f, 0.65f)));
+                snprintf(view.label, sizeof(view.label), "Item %d", i);
+                if (ImGui::Selectable(view.label, view.selected[i] != 0, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap | ImGuiSelectableFlags_AllowDoubleClick, ImVec2(0.0f, ImGui::GetFrameHeight()))) {
+                    clicked = i;
+                    if (ImGui::IsMouseDoubleClicked(0)) activated = i;
+                }
+                if (isCurrent && scrollToPlaying) { ImGui::SetScrollHereY(0.5f); view.scrolledTo = playing; }
+                ImGui::TableNextColumn(); ImGui::SetNextItemWidth(-FLT_MIN);
+                ImGui::SliderFloat("##Duration", &item.duration, 0.1f, 60.0f, "%.2f s");
+                if (ImGui::IsItemHovered()) ImGui::SetTooltip("Sets how long this playlist item will play.");
+                ImGui::TableNextColumn();
+                ImGui::Text("%d", (int)item.preset.freqsL.size());
+                ImGui::TableNextColumn();
+                ImGui::Text("%d", (int)item.preset.freqsR.size());
+                ImGui::PopID();
+            }
+        }
+        ImGui::EndTable();
+    }
+    if (!state.playlistPlaying) view.scrolledTo = -1;
+
+    if (clicked >= 0) {
+        ImGuiIO& io = ImGui::GetIO();
+        if (io.KeyShift && view.anchor >= 0) {
+            if (!io.KeyCtrl) std::fill(view.selected.begin(), view.selected.end(), 0);
+            for (int i = std::min(view.anchor, clicked); i <= std::max(view.anchor, clicked); i++) view.selected[i] = 1;
+        }
+        else {
+            if (io.KeyCtrl) view.selected[clicked] = !view.selected[clicked];
+            else { std::fill(view.selected.begin(), view.selected.end(), 0); view.selected[clicked] = 1; }
+            view.anchor = clicked;
         }
     }
-    if (itemInProgress) finalizeItem(currentItem);
-    state.currentPlaylistFile = path;
+    if (activated >= 0) {
+        if (state.playlistPlaying) { if (beginPlaylistItem(state, activated)) state.currentPlaylistItem = activated; }
+        else loadPlaylistItem(state, activated);
+    }
+    if (reorder) reorderPlaylist(state, order, std::move(selected));
+}
+
+// Rebuilds the playlist from source indices (an index may repeat for copies, or be missing for removed items).
+// Each item is moved on its last use and copied before that. The playing item keeps playing; if it was removed,
+// the item that took its place starts at once, and removing the tail lets the playlist end or loop as usual.
+void reorderPlaylist(AudioState& state, const std::vector<int>& order, std::vector<char>&& selected) {
+    std::vector<PlaylistItem>& items = state.playlist;
+    std::vector<int> uses(items.size(), 0);
+    for (int source : order) uses[source]++;
+    std::vector<PlaylistItem> rebuilt; rebuilt.reserve(order.size());
+    int current = state.currentPlaylistItem, newCurrent = -1, before = 0;
+    for (int i = 0; i < (int)order.size(); i++) {
+        int source = order[i];
+        if (--uses[source] == 0) rebuilt.push_back(std::move(items[source]));
+        else rebuilt.push_back(items[source]);
+        if (source == current && newCurrent < 0) newCurrent = i;
+        if (source < current) before++;
+    }
+    items = std::move(rebuilt);
+    if (current >= 0 && newCurrent < 0) {
+        if (!state.playlistPlaying) newCurrent = -1;
+        else if (before < (int)items.size() && beginPlaylistItem(state, before)) newCurrent = before;
+        else { newCurrent = before - 1; state.playlistTimer = 0.0f; }
+    }
+    state.currentPlaylistItem = newCurrent;
+    state.playlistView.selected = std::move(selected);
+    state.playlistView.anchor = -1;
 }
 
 void formatWaveToTextBuffer(AudioState& state) {
-    std::stringstream ss; ss.precision(3); ss << std::fixed;
-    ss << "L:{";
-    for (size_t i = 0; i < state.channelL.size(); ++i) { ss << formatRowToString(state.channelL[i]) << (i < state.channelL.size() - 1 ? "," : ""); }
-    ss << "}\nR:{";
-    for (size_t i = 0; i < state.channelR.size(); ++i) { ss << formatRowToString(state.channelR[i]) << (i < state.channelR.size() - 1 ? "," : ""); }
-    ss << "}";
-    strncpy_s(state.waveTextBuffer, sizeof(state.waveTextBuffer), ss.str().c_str(), _TRUNCATE);
+    WaveTextEditor& editor = state.waveEditor; TextWriter& out = state.textWriter;
+    if (editor.indexValid && editor.tokensL.size() == state.channelL.size() && editor.tokensR.size() == state.channelR.size()) {
+        long long shift = 0;
+        auto splice = [&](std::vector<WaveTextEditor::Token>& tokens, const std::vector<FrequencyRow>& rows) {
+            for (size_t i = 0; i < rows.size(); i++) {
+                WaveTextEditor::Token& token = tokens[i]; const FrequencyRow& row = rows[i];
+                token.offset = (size_t)((long long)token.offset + shift);
+                if (token.freq == row.freq && token.type == row.type && token.muted == row.muted) continue;
+                out.clear(); out.putRow(row);
+                editor.text.replace(token.offset, token.length, out.data.data(), out.size);
+                shift += (long long)out.size - (long long)token.length;
+                token = { token.offset, out.size, row.freq, row.type, row.muted };
+            }
+        };
+        splice(editor.tokensL, state.channelL); splice(editor.tokensR, state.channelR);
+        return;
+    }
+    out.clear();
+    auto putChannel = [&](std::vector<WaveTextEditor::Token>& tokens, const std::vector<FrequencyRow>& rows) {
+        tokens.clear();
+        for (size_t i = 0; i < rows.size(); i++) {
+            if (i) out.put(',');
+            size_t offset = out.size; out.putRow(rows[i]);
+            tokens.push_back({ offset, out.size - offset, rows[i].freq, rows[i].type, rows[i].muted });
+        }
+    };
+    out.put("L:{"); putChannel(editor.tokensL, state.channelL); out.put("}\nR:{"); putChannel(editor.tokensR, state.channelR); out.put('}');
+    editor.text.assign(out.data.data(), out.size);
+    editor.indexValid = true;
+}
+
+int waveTextResizeCallback(ImGuiInputTextCallbackData* data) {
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+        std::string* text = (std::string*)data->UserData;
+        text->resize(data->BufTextLen); data->Buf = (char*)text->c_str();
+    }
+    return 0;
 }
 
 bool parseTextBufferToWave(AudioState& state) {
+    ParseError error;
+    if (!parseWaveText(state.waveEditor.text, state.parseBank, error)) { state.parseErrorMsg = formatParseError("", error); return false; }
     state.parseErrorMsg.clear();
-    std::vector<FrequencyRow> newChannelL, newChannelR;
-    std::string text(state.waveTextBuffer);
-    size_t l_start = text.find("L:{"); size_t l_end = text.find("}", l_start);
-    size_t r_start = text.find("R:{"); size_t r_end = text.find("}", r_start);
-    if (l_start == std::string::npos || l_end == std::string::npos || r_start == std::string::npos || r_end == std::string::npos) {
-        state.parseErrorMsg = "Invalid format. Use L:{...} and R:{...}"; return false;
-    }
-    std::string l_data = text.substr(l_start + 3, l_end - (l_start + 3));
-    std::stringstream lss(l_data); std::string l_token; int l_item = 1;
-    while (std::getline(lss, l_token, ',')) {
-        if (l_token.empty() || l_token.find_first_not_of(" \t\n\v\f\r") == std::string::npos) continue;
-        try { newChannelL.push_back(parseRowFromString(l_token)); }
-        catch (...) { state.parseErrorMsg = "Channel L, item " + std::to_string(l_item) + ": '" + l_token + "' is invalid."; return false; }
-        l_item++;
-    }
-    std::string r_data = text.substr(r_start + 3, r_end - (r_start + 3));
-    std::stringstream rss(r_data); std::string r_token; int r_item = 1;
-    while (std::getline(rss, r_token, ',')) {
-        if (r_token.empty() || r_token.find_first_not_of(" \t\n\v\f\r") == std::string::npos) continue;
-        try { newChannelR.push_back(parseRowFromString(r_token)); }
-        catch (...) { state.parseErrorMsg = "Channel R, item " + std::to_string(r_item) + ": '" + r_token + "' is invalid."; return false; }
-        r_item++;
-    }
-    state.channelL = newChannelL; state.channelR = newChannelR;
+    publishBank(state, std::move(state.parseBank));
     return true;
 }
 
-GLuint createShaderProgram() {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER); glShaderSource(vertexShader, 1, &vertexShaderSource, NULL); glCompileShader(vertexShader);
+GLuint createShaderProgram(const char* vsSource, const char* fsSource) {
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER); glShaderSource(vertexShader, 1, &vsSource, NULL); glCompileShader(vertexShader);
     int success; char infoLog[512]; glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
     if (!success) {
         glGetShaderInfoLog(vertexShader, 512, NULL, infoLog); std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
     }
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER); glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL); glCompileShader(fragmentShader);
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER); glShaderSource(fragmentShader, 1, &fsSource, NULL); glCompileShader(fragmentShader);
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success) { glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog); std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl; }
     GLuint shaderProgram = glCreateProgram(); glAttachShader(shaderProgram, vertexShader); glAttachShader(shaderProgram, fragmentShader); glLinkProgram(shaderProgram);
@@ -810,54 +2048,59 @@ GLuint createShaderProgram() {
 
 float getStep(bool shift, bool ctrl) { if (ctrl && shift) return 0.01f; if (shift) return 0.1f; return 1.0f; }
 
+// Mix of all unmuted rows for one sample; advances every row's phase, muted or not.
+float synthesizeChannel(std::vector<FrequencyRow>& rows) {
+    float sum = 0.0f; int count = 0;
+    for (auto& row : rows) {
+        float sample = 0.0f;
+        switch (row.type) {
+        case SINE: sample = std::sin(row.phase); break;
+        case SQUARE: sample = (row.phase < PI) ? 0.5f : -0.5f; break;
+        case SAWTOOTH: sample = (row.phase / (float)PI) - 1.0f; break;
+        }
+        if (!row.muted) { sum += sample; count++; }
+        double phaseIncrement = 2.0 * PI * row.freq / SAMPLE_RATE; row.phase += phaseIncrement;
+        if (row.phase >= 2.0 * PI) { row.phase -= 2.0 * PI; }
+    }
+    return count > 0 ? sum / count : 0.0f;
+}
+
 int audioCallback(const void* inputBuffer, void* outputBuffer,
     unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void* userData) {
     AudioState* state = (AudioState*)userData;
     float* out = (float*)outputBuffer;
+    if (state->bankReady.load(std::memory_order_acquire)) { std::unique_lock<std::mutex> lock(state->bankMutex, std::try_to_lock); if (lock.owns_lock()) adoptPendingBank(*state); }
+    float pointRate = state->decimator.pointRate();
+    uint64_t blockStart = state->trail.head.load(std::memory_order_relaxed);
     for (unsigned long i = 0; i < framesPerBuffer; i++) {
-        float sumL = 0.0f, sumR = 0.0f; int countL = 0, countR = 0;
-        for (auto& row : state->channelL) {
-            float sample = 0.0f;
-            switch (row.type) {
-            case SINE: sample = std::sin(row.phase); break;
-            case SQUARE: sample = (row.phase < PI) ? 0.5f : -0.5f; break;
-            case SAWTOOTH: sample = (row.phase / (float)PI) - 1.0f; break;
-            }
-            if (!row.muted) { sumL += sample; countL++; }
-            double phaseIncrement = 2.0 * PI * row.freq / SAMPLE_RATE; row.phase += phaseIncrement;
-            if (row.phase >= 2.0 * PI) { row.phase -= 2.0 * PI; }
-        }
-        for (auto& row : state->channelR) {
-            float sample = 0.0f;
-            switch (row.type) {
-            case SINE: sample = std::sin(row.phase); break;
-            case SQUARE: sample = (row.phase < PI) ? 0.5f : -0.5f; break;
-            case SAWTOOTH: sample = (row.phase / (float)PI) - 1.0f; break;
-            }
-            if (!row.muted) { sumR += sample; countR++; }
-            double phaseIncrement = 2.0 * PI * row.freq / SAMPLE_RATE; row.phase += phaseIncrement;
-            if (row.phase >= 2.0 * PI) { row.phase -= 2.0 * PI; }
-        }
-        float sampleL = countL > 0 ? sumL / countL : 0.0f; float sampleR = countR > 0 ? sumR / countR : 0.0f;
+        float sampleL = synthesizeChannel(state->channelL); float sampleR = synthesizeChannel(state->channelR);
         if (state->audioMuted) { *out++ = 0.0f; *out++ = 0.0f; }
         else { *out++ = sampleL * 0.5f; *out++ = sampleR * 0.5f; }
-        if (i % 2 == 0) {
-            std::lock_guard<std::mutex> lock(state->bufferMutex);
-            state->lissajousL.push_back(sampleL); state->lissajousR.push_back(sampleR);
-            if (state->lissajousL.size() > BUFFER_SIZE) { state->lissajousL.erase(state->lissajousL.begin()); state->lissajousR.erase(state->lissajousR.begin()); }
-        }
+        state->rawRing.push(sampleL, sampleR);
+        float points[4]; int emitted = state->decimator.push(sampleL, sampleR, points);
+        for (int k = 0; k < emitted; k++) { state->trail.push(points[k * 2], points[k * 2 + 1]); state->normalizer.push(points[k * 2], points[k * 2 + 1], pointRate); }
     }
+    state->blockClock.push(blockStart, timeInfo->outputBufferDacTime, timeInfo->outputBufferDacTime - timeInfo->currentTime);
     return paContinue;
 }
 
-void drawLissajousGL(AudioState& state, int x, int y, int width, int height, GLuint shaderProgram, GLuint vao, GLuint vbo) {
-    std::vector<float> dataL, dataR;
-    { std::lock_guard<std::mutex> lock(state.bufferMutex); dataL = state.lissajousL; dataR = state.lissajousR; }
-    if (dataL.size() < 2) return;
-    glViewport(x, y, width, height); glUseProgram(shaderProgram); glBindVertexArray(vao); glBindBuffer(GL_ARRAY_BUFFER, vbo);
+void drawLissajousGL(AudioState& state, int x, int y, int width, int height, ScopeGL& gl) {
+    if (gl.store.length != (size_t)state.trailLength) resizeTrailStoreGL(gl.store, state.trailLength);
+    ingestTrailGL(state, gl.store);
+    TrailLevel& base = gl.store.levels[0];
+    uint64_t available = (std::min)(base.head, (uint64_t)base.capacity);
+    if (available < 2) return;
+    // Hold the picture back by however far the newest points run ahead of what the DAC is playing right now.
+    // store.consumed is the ring index that corresponds to base.head.
+    uint64_t lag = 0; float pointRate = state.decimator.pointRate(); double position;
+    if (state.syncToAudio && state.running && state.blockClock.positionAt(state.streamTime, pointRate, position) && position < (double)gl.store.consumed)
+        lag = (std::min)((uint64_t)((double)gl.store.consumed - position), available - 2);
+    state.displayLagMs = lag / pointRate * 1000.0f;
+    size_t filled = (size_t)(std::min)(available - lag, (uint64_t)gl.store.length);
+    glViewport(x, y, width, height); glUseProgram(gl.shaderProgram); glBindVertexArray(gl.vao); glBindBuffer(GL_ARRAY_BUFFER, gl.vbo);
     float left = 0.0f, right = (float)width, bottom = (float)height, top = 0.0f;
     float proj[16] = { 2 / (right - left),0,0,0, 0,2 / (top - bottom),0,0, 0,0,-2 / (1.f - -1.f),0, -(right + left) / (right - left),-(top + bottom) / (top - bottom),-(1.f - 1.f) / (1.f - -1.f),1 };
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, proj);
+    glUniformMatrix4fv(glGetUniformLocation(gl.shaderProgram, "projection"), 1, GL_FALSE, proj);
     float centerX = width / 2.0f; float centerY = height / 2.0f; float scale = (std::min)(width, height) / 2.0f - 20.0f;
     glDisableVertexAttribArray(1);
     glVertexAttrib4f(1, 0.15f, 0.15f, 0.15f, 1.0f); glLineWidth(1.0f);
@@ -873,36 +2116,537 @@ void drawLissajousGL(AudioState& state, int x, int y, int width, int height, GLu
         }
         glBufferData(GL_ARRAY_BUFFER, circleVertices.size() * sizeof(float), circleVertices.data(), GL_DYNAMIC_DRAW); glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)circleVertices.size() / 2);
     }
-    float maxVal = 0.001f;
-    for (size_t i = 0; i < dataL.size(); i++) { maxVal = (std::max)(maxVal, std::abs(dataL[i])); maxVal = (std::max)(maxVal, std::abs(dataR[i])); }
-    glEnableVertexAttribArray(1);
-    size_t numPoints = (size_t)(dataL.size() * state.trailPercent / 100.0f); if (numPoints < 2) numPoints = 2; size_t start = dataL.size() > numPoints ? dataL.size() - numPoints : 0;
-    std::vector<float> lissajousVertices; lissajousVertices.reserve(numPoints * 6);
-    for (size_t i = start; i < dataL.size(); i++) {
-        lissajousVertices.push_back(centerX + (dataL[i] / maxVal) * scale); lissajousVertices.push_back(centerY - (dataR[i] / maxVal) * scale);
-        float progress = (numPoints > 1) ? (float)(i - start) / (float)(numPoints - 1) : 1.0f; float alpha = progress * progress;
-        lissajousVertices.push_back(0.0f); lissajousVertices.push_back(1.0f); lissajousVertices.push_back(0.0f); lissajousVertices.push_back(alpha);
-    }
-    glLineWidth(2.0f); glBufferData(GL_ARRAY_BUFFER, lissajousVertices.size() * sizeof(float), lissajousVertices.data(), GL_DYNAMIC_DRAW); glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)lissajousVertices.size() / 6);
-    glDisableVertexAttribArray(1);
-    if (state.showStartEndPoints) {
-        if (!lissajousVertices.empty()) {
-            float startPoint[] = { lissajousVertices[0], lissajousVertices[1] }; glPointSize(8.0f);
-            glVertexAttrib4f(1, 1.0f, 0.0f, 0.0f, 1.0f); glBufferData(GL_ARRAY_BUFFER, sizeof(startPoint), startPoint, GL_DYNAMIC_DRAW); glDrawArrays(GL_POINTS, 0, 1);
+
+    size_t numPoints = (size_t)(filled * state.trailPercent / 100.0f); if (numPoints < 2) numPoints = 2;
+    state.normalizer.window.store(numPoints, std::memory_order_relaxed);
+    float maxVal = state.normalizer.level.load(std::memory_order_relaxed);
+    glUseProgram(gl.trailProgram); glBindVertexArray(gl.trailVao);
+    glUniformMatrix4fv(glGetUniformLocation(gl.trailProgram, "projection"), 1, GL_FALSE, proj);
+    glUniform2f(glGetUniformLocation(gl.trailProgram, "center"), centerX, centerY);
+    glUniform1f(glGetUniformLocation(gl.trailProgram, "scale"), scale / maxVal);
+    glUniform1f(glGetUniformLocation(gl.trailProgram, "lineWidth"), state.lineWidth);
+    glUniform4f(glGetUniformLocation(gl.trailProgram, "lineColor"), 0.0f, 1.0f, 0.0f, 1.0f);
+    if (state.renderMode == RENDER_HEATMAP) drawHeatmapGL(state, gl, x, y, width, height, scale / (width / 2.0f) / maxVal);
+    else {
+        // Pick the coarsest detail that still gives about one point per scope pixel.
+        size_t budget = (size_t)width * height; int lod = 0;
+        while (lod + 1 < TRAIL_LOD_LEVELS && (numPoints >> lod) > budget) lod++;
+        TrailLevel& level = gl.store.levels[lod];
+        uint64_t levelLag = (std::min)(lag >> lod, level.head), levelEnd = level.head - levelLag;
+        size_t visible = (std::min)((std::max)(numPoints >> lod, (size_t)2), (size_t)(std::min)(levelEnd, (uint64_t)(level.capacity - levelLag)));
+        if (visible >= 2) {
+            glUniform1i(glGetUniformLocation(gl.trailProgram, "segmentCount"), (GLint)(visible - 1));
+            GLint offsetLocation = glGetUniformLocation(gl.trailProgram, "segmentOffset");
+            glBindBuffer(GL_ARRAY_BUFFER, level.vbo);
+            auto drawRun = [&](size_t slot, size_t segments, size_t offset) {
+                if (segments == 0) return;
+                glUniform1i(offsetLocation, (GLint)offset);
+                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)(slot * 2 * sizeof(float)));
+                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)((slot + 1) * 2 * sizeof(float)));
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)segments);
+            };
+            // The slot after the last one mirrors slot 0, so the segment across the wrap belongs to the first run.
+            size_t slot = (size_t)((levelEnd - visible) % level.capacity);
+            size_t firstRun = (std::min)(visible, level.capacity - slot);
+            // MAX blending keeps the overlapping caps at each join from compounding their alpha.
+            glBlendEquation(GL_MAX);
+            drawRun(slot, firstRun < visible ? firstRun : firstRun - 1, 0);
+            if (firstRun < visible) drawRun(0, visible - firstRun - 1, firstRun);
+            glBlendEquation(GL_FUNC_ADD);
         }
-        if (lissajousVertices.size() >= 6) {
-            float endPoint[] = { lissajousVertices[lissajousVertices.size() - 6], lissajousVertices[lissajousVertices.size() - 5] }; glPointSize(10.0f);
-            glVertexAttrib4f(1, 1.0f, 1.0f, 1.0f, 1.0f); glBufferData(GL_ARRAY_BUFFER, sizeof(endPoint), endPoint, GL_DYNAMIC_DRAW); glDrawArrays(GL_POINTS, 0, 1);
+    }
+
+    if (state.showStartEndPoints) {
+        glUseProgram(gl.markerProgram); glBindVertexArray(gl.trailVao); glBindBuffer(GL_ARRAY_BUFFER, base.vbo);
+        glUniformMatrix4fv(glGetUniformLocation(gl.markerProgram, "projection"), 1, GL_FALSE, proj);
+        glUniform2f(glGetUniformLocation(gl.markerProgram, "center"), centerX, centerY);
+        glUniform1f(glGetUniformLocation(gl.markerProgram, "scale"), scale / maxVal);
+        auto drawMarker = [&](uint64_t index, float size, float r, float g, float b) {
+            size_t slot = (size_t)(index % base.capacity);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)(slot * 2 * sizeof(float)));
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)(slot * 2 * sizeof(float)));
+            glUniform1f(glGetUniformLocation(gl.markerProgram, "pointSize"), size);
+            glUniform4f(glGetUniformLocation(gl.markerProgram, "color"), r, g, b, 1.0f);
+            glDrawArraysInstanced(GL_POINTS, 0, 1, 1);
+        };
+        drawMarker(base.head - lag - numPoints, 8.0f, 1.0f, 0.0f, 0.0f);
+        drawMarker(base.head - lag - 1, 10.0f, 1.0f, 1.0f, 1.0f);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0); glBindVertexArray(0);
+}
+
+void resizeTrailStoreGL(TrailStore& store, size_t length) {
+    store.length = length; store.consumed = 0;
+    for (int k = 0; k < TRAIL_LOD_LEVELS; k++) {
+        TrailLevel& level = store.levels[k];
+        level.capacity = (std::max)((length + TRAIL_LATENCY_HEADROOM) >> k, (size_t)64); level.head = 0;
+        level.envelope.factor = 4; level.envelope.method = DECIMATE_MINMAX; level.envelope.fixedPairs = true; level.envelope.filled = 0;
+        level.staging.clear(); level.staging.reserve((TRAIL_RING_CAPACITY >> k) + 4);
+        if (!level.vbo) glGenBuffers(1, &level.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, level.vbo);
+        glBufferData(GL_ARRAY_BUFFER, (level.capacity + 1) * 2 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void appendTrailLevelGL(TrailLevel& level, const float* xy, size_t count) {
+    glBindBuffer(GL_ARRAY_BUFFER, level.vbo);
+    while (count > 0) {
+        size_t slot = (size_t)(level.head % level.capacity);
+        size_t run = (std::min)((std::min)(count, level.capacity - slot), (size_t)TRAIL_UPLOAD_CHUNK);
+        glBufferSubData(GL_ARRAY_BUFFER, slot * 2 * sizeof(float), run * 2 * sizeof(float), xy);
+        if (slot == 0) glBufferSubData(GL_ARRAY_BUFFER, level.capacity * 2 * sizeof(float), 2 * sizeof(float), xy);
+        level.head += run; xy += run * 2; count -= run;
+    }
+}
+
+// Moves the points published since the last frame from the trail ring into the GPU store, and pushes each
+// level's output through its envelope to build the next one. At most half the ring is taken per frame so the
+// audio thread cannot lap the span while it is being read.
+void ingestTrailGL(AudioState& state, TrailStore& store) {
+    uint64_t head = state.trail.head.load(std::memory_order_acquire);
+    TrailSpan span = state.trail.latest((size_t)(std::min)(head - store.consumed, (uint64_t)state.trail.capacity / 2));
+    store.consumed = span.end;
+    if (span.count == 0) return;
+    const float* input = span.xy; size_t inputCount = span.count;
+    for (int k = 0; k < TRAIL_LOD_LEVELS && inputCount > 0; k++) {
+        TrailLevel& level = store.levels[k];
+        appendTrailLevelGL(level, input, inputCount);
+        if (k + 1 == TRAIL_LOD_LEVELS) break;
+        std::vector<float>& next = store.levels[k + 1].staging; next.clear();
+        float points[4];
+        for (size_t i = 0; i < inputCount; i++) {
+            int emitted = level.envelope.push(input[i * 2], input[i * 2 + 1], points);
+            next.insert(next.end(), points, points + emitted * 2);
         }
+        input = next.data(); inputCount = next.size() / 2;
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void initHeatmapGL(ScopeGL& gl) {
+    gl.heatSplatProgram = createShaderProgram(heatSplatVertexShaderSource, heatSplatFragmentShaderSource);
+    gl.heatDecayProgram = createShaderProgram(fullscreenVertexShaderSource, heatSplatFragmentShaderSource);
+    gl.heatDisplayProgram = createShaderProgram(fullscreenVertexShaderSource, heatDisplayFragmentShaderSource);
+    glGenVertexArrays(1, &gl.heatVao); glGenBuffers(1, &gl.heatVbo); glGenVertexArrays(1, &gl.fullscreenVao);
+    glBindVertexArray(gl.heatVao); glBindBuffer(GL_ARRAY_BUFFER, gl.heatVbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0); glBindVertexArray(0);
+    const float stops[5][4] = { { 0.00f, 0.0f, 0.0f, 0.0f }, { 0.25f, 0.30f, 0.0f, 0.50f }, { 0.50f, 0.85f, 0.15f, 0.20f }, { 0.75f, 1.0f, 0.60f, 0.0f }, { 1.00f, 1.0f, 1.0f, 0.90f } };
+    float lut[256 * 3];
+    for (int i = 0; i < 256; i++) {
+        float t = i / 255.0f; int s = 0; while (s < 3 && t > stops[s + 1][0]) s++;
+        float f = (t - stops[s][0]) / (stops[s + 1][0] - stops[s][0]);
+        for (int c = 0; c < 3; c++) lut[i * 3 + c] = stops[s][c + 1] + (stops[s + 1][c + 1] - stops[s][c + 1]) * f;
+    }
+    glGenTextures(1, &gl.lutTex); glBindTexture(GL_TEXTURE_1D, gl.lutTex);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGB32F, 256, 0, GL_RGB, GL_FLOAT, lut);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    glGenFramebuffers(1, &gl.heatFbo);
+}
+
+// Accumulates every raw sample since the last frame into an R32F texture with additive blending, then tone maps it over the scope.
+void drawHeatmapGL(AudioState& state, ScopeGL& gl, int x, int y, int width, int height, float gain) {
+    if (gl.heatSize != state.heatmapSize) {
+        gl.heatSize = state.heatmapSize;
+        if (gl.heatTex) glDeleteTextures(1, &gl.heatTex);
+        glGenTextures(1, &gl.heatTex); glBindTexture(GL_TEXTURE_2D, gl.heatTex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, gl.heatSize, gl.heatSize, 0, GL_RED, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindFramebuffer(GL_FRAMEBUFFER, gl.heatFbo); glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gl.heatTex, 0);
+        glViewport(0, 0, gl.heatSize, gl.heatSize); glClearColor(0.0f, 0.0f, 0.0f, 0.0f); glClear(GL_COLOR_BUFFER_BIT);
+    }
+    uint64_t head = state.rawRing.head.load(std::memory_order_acquire);
+    uint64_t end = (std::max)(head - (std::min)((uint64_t)(state.displayLagMs * 0.001f * SAMPLE_RATE), head), gl.heatHead);
+    TrailSpan span = state.rawRing.ending(end, (size_t)(std::min)(end - gl.heatHead, (uint64_t)state.rawRing.capacity / 2));
+    glBindFramebuffer(GL_FRAMEBUFFER, gl.heatFbo); glViewport(0, 0, gl.heatSize, gl.heatSize);
+    if (span.count > 0) {
+        // Fade by signal time rather than frame time, so the density freezes with the audio.
+        float decay = std::exp(-(float)span.count / SAMPLE_RATE / (std::max)(state.heatPersistence, 0.01f));
+        glUseProgram(gl.heatDecayProgram); glBindVertexArray(gl.fullscreenVao);
+        glBlendFunc(GL_ZERO, GL_CONSTANT_ALPHA); glBlendColor(0.0f, 0.0f, 0.0f, decay); glDrawArrays(GL_TRIANGLES, 0, 3);
+        glUseProgram(gl.heatSplatProgram); glBindVertexArray(gl.heatVao); glBindBuffer(GL_ARRAY_BUFFER, gl.heatVbo);
+        glBufferData(GL_ARRAY_BUFFER, span.count * 2 * sizeof(float), span.xy, GL_STREAM_DRAW);
+        glUniform1f(glGetUniformLocation(gl.heatSplatProgram, "gain"), gain);
+        glBlendFunc(GL_ONE, GL_ONE); glDrawArrays(GL_POINTS, 0, (GLsizei)span.count);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl.heatHead = span.end;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0); glViewport(x, y, width, height);
+    glUseProgram(gl.heatDisplayProgram); glBindVertexArray(gl.fullscreenVao);
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, gl.heatTex); glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_1D, gl.lutTex);
+    glUniform1i(glGetUniformLocation(gl.heatDisplayProgram, "heat"), 0); glUniform1i(glGetUniformLocation(gl.heatDisplayProgram, "lut"), 1);
+    glUniform1i(glGetUniformLocation(gl.heatDisplayProgram, "toneMap"), state.heatToneMap);
+    glUniform1f(glGetUniformLocation(gl.heatDisplayProgram, "fullScale"), (std::max)(state.heatFullScale, 1.0f));
+    glUniform1f(glGetUniformLocation(gl.heatDisplayProgram, "gamma"), state.heatGamma);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindTexture(GL_TEXTURE_1D, 0); glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Hands every slot whose readback has completed to the encoder pool; with `wait`, blocks until all are done.
+void finishCaptureGL(FrameCapture& capture, bool wait) {
+    while (capture.pendingSlots > 0) {
+        CaptureSlot& slot = capture.slots[(capture.writeSlot - capture.pendingSlots + CAPTURE_PBO_COUNT) % CAPTURE_PBO_COUNT];
+        GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000ull : 0);
+        if (status == GL_TIMEOUT_EXPIRED) break;
+        glDeleteSync(slot.fence); slot.fence = nullptr; capture.pendingSlots--;
+        size_t size = (size_t)slot.width * slot.height * 4;
+        std::vector<unsigned char> pixels;
+        { std::lock_guard<std::mutex> lock(capture.bufferMutex); if (!capture.freeBuffers.empty()) { pixels = std::move(capture.freeBuffers.back()); capture.freeBuffers.pop_back(); } }
+        pixels.resize(size);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (mapped) { std::memcpy(pixels.data(), mapped, size); glUnmapBuffer(GL_PIXEL_PACK_BUFFER); }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!mapped) { capture.framesFailed++; continue; }
+        FrameCapture* owner = &capture; std::string path = slot.path; int width = slot.width, height = slot.height, format = slot.format;
+        capture.encoders.submit([owner, path, width, height, format, pixels = std::move(pixels)]() mutable {
+            bool ok = format == CAPTURE_RAW ? writeRawFile(path, pixels.data(), width, height) : writePngFile(path, pixels.data(), width, height);
+            if (ok) owner->framesWritten++; else owner->framesFailed++;
+            std::lock_guard<std::mutex> lock(owner->bufferMutex); owner->freeBuffers.push_back(std::move(pixels));
+        });
+    }
+}
+
+void captureScopeGL(AudioState& state, FrameCapture& capture, int x, int y, int width, int height) {
+    finishCaptureGL(capture, false);
+    bool screenshot = state.screenshotRequested;
+    if (!screenshot && !state.recording) return;
+    if (width <= 0 || height <= 0) return;
+    // The renderer never waits on a fence: with every slot still in flight a screenshot stays requested and is
+    // retried next frame, while a recording drops the frame, as it does when the encoders fall behind.
+    if (capture.pendingSlots == CAPTURE_PBO_COUNT && screenshot) return;
+    if (capture.pendingSlots == CAPTURE_PBO_COUNT || (!screenshot && capture.encoders.pending.load() >= CAPTURE_MAX_QUEUED)) { capture.framesDropped++; return; }
+    state.screenshotRequested = false;
+    CaptureSlot& slot = capture.slots[capture.writeSlot];
+    if (!slot.pbo) glGenBuffers(1, &slot.pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    if (slot.width != width || slot.height != height) { glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, nullptr, GL_STREAM_READ); slot.width = width; slot.height = height; }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.format = state.captureFormat;
+    const char* ext = slot.format == CAPTURE_RAW ? "rgba" : "png";
+    char name[64];
+    if (screenshot) {
+        // Milliseconds plus a counter, so two screenshots in the same second or millisecond never overwrite each other.
+        long long ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        std::snprintf(name, sizeof(name), "/lissgen_%lld_%03d_%d.%s", ms / 1000, (int)(ms % 1000), capture.screenshotCount++, ext);
+    }
+    else std::snprintf(name, sizeof(name), "/lissgen_%lld_%06d.%s", capture.sessionId, capture.sequenceFrame++, ext);
+    slot.path = std::string(state.captureDir) + name;
+    capture.writeSlot = (capture.writeSlot + 1) % CAPTURE_PBO_COUNT; capture.pendingSlots++;
+}
+
+static uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t len) {
+    // Built once under the magic-static guard; the PNG encoders call this from several workers at once.
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; n++) { uint32_t c = n; for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1; t[n] = c; }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Rows are flipped from GL's bottom-up order. The zlib stream uses stored blocks: PNG stays dependency-free
+// and encoding is a single linear pass.
+bool writePngFile(const std::string& path, const unsigned char* rgba, int width, int height) {
+    size_t rowBytes = (size_t)width * 4 + 1, rawSize = rowBytes * height;
+    size_t blocks = (rawSize + 65534) / 65535;
+    std::vector<unsigned char> idat; idat.reserve(2 + rawSize + blocks * 5 + 4);
+    idat.push_back(0x78); idat.push_back(0x01);
+    uint32_t adlerA = 1, adlerB = 0; size_t written = 0;
+    std::vector<unsigned char> row(rowBytes, 0);
+    size_t blockLeft = 0;
+    for (int r = 0; r < height; r++) {
+        std::memcpy(row.data() + 1, rgba + (size_t)(height - 1 - r) * width * 4, (size_t)width * 4);
+        for (size_t i = 0; i < rowBytes; i++) {
+            if (blockLeft == 0) {
+                size_t len = (std::min)((size_t)65535, rawSize - written);
+                idat.push_back(written + len == rawSize ? 1 : 0);
+                idat.push_back((unsigned char)(len & 0xFF)); idat.push_back((unsigned char)(len >> 8));
+                idat.push_back((unsigned char)(~len & 0xFF)); idat.push_back((unsigned char)((~len >> 8) & 0xFF));
+                blockLeft = len;
+            }
+            idat.push_back(row[i]); blockLeft--; written++;
+            adlerA = (adlerA + row[i]) % 65521; adlerB = (adlerB + adlerA) % 65521;
+        }
+    }
+    uint32_t adler = (adlerB << 16) | adlerA;
+    for (int s = 24; s >= 0; s -= 8) idat.push_back((unsigned char)(adler >> s));
+    FILE* file = std::fopen(path.c_str(), "wb"); if (!file) return false;
+    auto writeChunk = [file](const char* type, const unsigned char* data, size_t len) {
+        unsigned char header[8] = { (unsigned char)(len >> 24), (unsigned char)(len >> 16), (unsigned char)(len >> 8), (unsigned char)len, (unsigned char)type[0], (unsigned char)type[1], (unsigned char)type[2], (unsigned char)type[3] };
+        uint32_t crc = crc32Update(crc32Update(0, header + 4, 4), data, len);
+        unsigned char footer[4] = { (unsigned char)(crc >> 24), (unsigned char)(crc >> 16), (unsigned char)(crc >> 8), (unsigned char)crc };
+        std::fwrite(header, 1, 8, file); if (len) std::fwrite(data, 1, len, file); std::fwrite(footer, 1, 4, file);
+    };
+    const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    unsigned char ihdr[13] = { (unsigned char)(width >> 24), (unsigned char)(width >> 16), (unsigned char)(width >> 8), (unsigned char)width, (unsigned char)(height >> 24), (unsigned char)(height >> 16), (unsigned char)(height >> 8), (unsigned char)height, 8, 6, 0, 0, 0 };
+    std::fwrite(signature, 1, 8, file);
+    writeChunk("IHDR", ihdr, 13); writeChunk("IDAT", idat.data(), idat.size()); writeChunk("IEND", nullptr, 0);
+    return std::fclose(file) == 0;
+}
+
+bool writeRawFile(const std::string& path, const unsigned char* rgba, int width, int height) {
+    FILE* file = std::fopen(path.c_str(), "wb"); if (!file) return false;
+    for (int r = height - 1; r >= 0; r--) std::fwrite(rgba + (size_t)r * width * 4, 1, (size_t)width * 4, file);
+    return std::fclose(file) == 0;
+}
+
+// Output is RGBA8, bottom-up like a GL readback, so it goes straight into writePngFile/writeRawFile.
+// Without a pool the tile rows are drawn on the calling thread.
+void rasterizeScopeCPU(ScopeRaster& raster, WorkerPool* pool, const float* xy, size_t count, float maxVal, float lineWidth, bool markers, unsigned char* rgba) {
+    int width = raster.width, height = raster.height;
+    float centerX = width / 2.0f, centerY = height / 2.0f, scale = (std::min)(width, height) / 2.0f - raster.margin, gain = scale / maxVal;
+    int tilesX = (width + RASTER_TILE - 1) / RASTER_TILE, tilesY = (height + RASTER_TILE - 1) / RASTER_TILE;
+    raster.points.resize(count * 2);
+    for (size_t i = 0; i < count; i++) { raster.points[i * 2] = centerX + xy[i * 2] * gain; raster.points[i * 2 + 1] = centerY - xy[i * 2 + 1] * gain; }
+    raster.bins.resize((size_t)tilesX * tilesY);
+    for (auto& bin : raster.bins) bin.clear();
+    float reach = lineWidth * 0.5f + 1.0f;
+    for (size_t i = 0; i + 1 < count; i++) {
+        const float* a = &raster.points[i * 2]; const float* b = a + 2;
+        int tx0 = (std::max)(0, (int)std::floor(((std::min)(a[0], b[0]) - reach) / RASTER_TILE)), tx1 = (std::min)(tilesX - 1, (int)std::floor(((std::max)(a[0], b[0]) + reach) / RASTER_TILE));
+        int ty0 = (std::max)(0, (int)std::floor(((std::min)(a[1], b[1]) - reach) / RASTER_TILE)), ty1 = (std::min)(tilesY - 1, (int)std::floor(((std::max)(a[1], b[1]) + reach) / RASTER_TILE));
+        for (int ty = ty0; ty <= ty1; ty++) for (int tx = tx0; tx <= tx1; tx++) raster.bins[(size_t)ty * tilesX + tx].push_back((uint32_t)i);
+    }
+    // Graticule: 1px anti-aliased axes, then the four rings, composited over black as the GL pass does. It only depends on size.
+    if (raster.graticule.size() != (size_t)width * height) {
+        raster.graticule.resize((size_t)width * height);
+        for (int py = 0; py < height; py++) for (int px = 0; px < width; px++) {
+            float fx = px + 0.5f, fy = py + 0.5f, c = 0.0f;
+            float axis = (std::max)(1.0f - std::fabs(fx - centerX), 1.0f - std::fabs(fy - centerY));
+            if (axis > 0.0f) c = 0.15f * axis;
+            float radius = std::sqrt((fx - centerX) * (fx - centerX) + (fy - centerY) * (fy - centerY));
+            for (int k = 1; k <= 4; k++) { float ring = 1.0f - std::fabs(radius - scale * k / 4.0f); if (ring > 0.0f) c = c * (1.0f - ring) + 0.12f * ring; }
+            raster.graticule[(size_t)py * width + px] = c;
+        }
+    }
+    const float* first = count ? &raster.points[0] : nullptr; const float* last = count ? &raster.points[(count - 1) * 2] : nullptr;
+    for (int ty = 0; ty < tilesY; ty++) {
+        auto tileRow = [&, ty] {
+            std::vector<float> tile(RASTER_TILE * RASTER_TILE * 3);
+            for (int tx = 0; tx < tilesX; tx++) {
+                int x0 = tx * RASTER_TILE, y0 = ty * RASTER_TILE, x1 = (std::min)(x0 + RASTER_TILE, width), y1 = (std::min)(y0 + RASTER_TILE, height);
+                for (int py = y0; py < y1; py++) for (int px = x0; px < x1; px++) {
+                    float* p = &tile[((py - y0) * RASTER_TILE + (px - x0)) * 3]; p[0] = p[1] = p[2] = raster.graticule[(size_t)py * width + px];
+                }
+                for (uint32_t i : raster.bins[(size_t)ty * tilesX + tx]) {
+                    const float* a = &raster.points[i * 2]; float bax = a[2] - a[0], bay = a[3] - a[1];
+                    float len2 = (std::max)(bax * bax + bay * bay, 1e-6f);
+                    int sx0 = (std::max)(x0, (int)((std::min)(a[0], a[2]) - reach)), sx1 = (std::min)(x1 - 1, (int)((std::max)(a[0], a[2]) + reach));
+                    int sy0 = (std::max)(y0, (int)((std::min)(a[1], a[3]) - reach)), sy1 = (std::min)(y1 - 1, (int)((std::max)(a[1], a[3]) + reach));
+                    for (int py = sy0; py <= sy1; py++) for (int px = sx0; px <= sx1; px++) {
+                        float pax = px + 0.5f - a[0], pay = py + 0.5f - a[1];
+                        float h = (std::min)((std::max)((pax * bax + pay * bay) / len2, 0.0f), 1.0f);
+                        float dx = pax - bax * h, dy = pay - bay * h;
+                        float coverage = (std::min)((std::max)(lineWidth * 0.5f - std::sqrt(dx * dx + dy * dy) + 0.5f, 0.0f), 1.0f);
+                        float t = (i + h) / (float)(count - 1);
+                        float* p = &tile[((py - y0) * RASTER_TILE + (px - x0)) * 3]; p[1] = (std::max)(p[1], coverage * t * t);
+                    }
+                }
+                if (markers && first) {
+                    auto stamp = [&](const float* at, float size, float r, float g, float b) {
+                        for (int py = (std::max)(y0, (int)std::ceil(at[1] - size / 2 - 0.5f)); py < (std::min)(y1, (int)std::ceil(at[1] + size / 2 - 0.5f)); py++)
+                            for (int px = (std::max)(x0, (int)std::ceil(at[0] - size / 2 - 0.5f)); px < (std::min)(x1, (int)std::ceil(at[0] + size / 2 - 0.5f)); px++) {
+                                float* p = &tile[((py - y0) * RASTER_TILE + (px - x0)) * 3]; p[0] = r; p[1] = g; p[2] = b;
+                            }
+                    };
+                    stamp(first, 8.0f, 1.0f, 0.0f, 0.0f); stamp(last, 10.0f, 1.0f, 1.0f, 1.0f);
+                }
+                for (int py = y0; py < y1; py++) {
+                    unsigned char* out = rgba + ((size_t)(height - 1 - py) * width + x0) * 4;
+                    const float* p = &tile[(py - y0) * RASTER_TILE * 3];
+                    for (int px = x0; px < x1; px++, p += 3, out += 4) { out[0] = (unsigned char)(p[0] * 255.0f + 0.5f); out[1] = (unsigned char)(p[1] * 255.0f + 0.5f); out[2] = (unsigned char)(p[2] * 255.0f + 0.5f); out[3] = 255; }
+                }
+            }
+        };
+        if (pool) pool->submit(tileRow); else tileRow();
+    }
+    if (pool) pool->wait();
+}
+
+std::string thumbnailCacheDir() {
+#ifdef _WIN32
+    const char* base = std::getenv("LOCALAPPDATA");
+    std::string dir = base ? std::string(base) + "\\LissGen\\thumbnails" : std::string();
+#else
+    const char* xdg = std::getenv("XDG_CACHE_HOME"); const char* home = std::getenv("HOME");
+    std::string dir = xdg && *xdg ? std::string(xdg) + "/LissGen/thumbnails" : home ? std::string(home) + "/.cache/LissGen/thumbnails" : std::string();
+#endif
+    std::error_code ec; if (!dir.empty()) std::filesystem::create_directories(dir, ec);
+    return ec ? std::string() : dir;
+}
+
+// Playlists preview their first item. Without a cache folder every preview is rendered again.
+bool generatePresetThumbnail(ThumbnailCache& cache, const std::string& path, IGFD_Thumbnail_Info* info) {
+    int size = (int)DisplayMode_ThumbailsList_ImageHeight;
+    std::error_code ec;
+    auto modified = std::filesystem::last_write_time(path, ec); if (ec) return false;
+    auto bytes = std::filesystem::file_size(path, ec); if (ec) return false;
+    std::string key = path + '\n' + std::to_string((long long)modified.time_since_epoch().count()) + '\n' + std::to_string((unsigned long long)bytes) + '\n' + std::to_string(size);
+    uint64_t hash = 1469598103934665603ull; for (unsigned char c : key) { hash ^= c; hash *= 1099511628211ull; }
+    char name[32]; std::snprintf(name, sizeof(name), "/%016llx.thumb", (unsigned long long)hash);
+    std::string cached = cache.dir.empty() ? std::string() : cache.dir + name;
+    std::vector<unsigned char> rgba((size_t)size * size * 4);
+    if (cached.empty() || !readThumbnailFile(cached, key, rgba)) {
+        WavePreset bank;
+        if (!readFirstPresetItem(path, bank)) return false;
+        std::vector<float> xy(THUMBNAIL_SAMPLES * 2); float maxVal = 1e-3f;
+        for (size_t i = 0; i < THUMBNAIL_SAMPLES; i++) {
+            xy[i * 2] = synthesizeChannel(bank.freqsL); xy[i * 2 + 1] = synthesizeChannel(bank.freqsR);
+            maxVal = (std::max)(maxVal, (std::max)(std::fabs(xy[i * 2]), std::fabs(xy[i * 2 + 1])));
+        }
+        ScopeRaster raster; raster.width = size; raster.height = size; raster.margin = 2.0f;
+        rasterizeScopeCPU(raster, nullptr, xy.data(), THUMBNAIL_SAMPLES, maxVal, 1.0f, false, rgba.data());
+        if (!cached.empty()) writeThumbnailFile(cached, key, rgba);
+    }
+    // The rasterizer writes bottom-up rows; ImGui samples textures top-down.
+    size_t row = (size_t)size * 4; unsigned char* pixels = new unsigned char[rgba.size()];
+    for (int r = 0; r < size; r++) std::memcpy(pixels + r * row, rgba.data() + (size - 1 - r) * row, row);
+    info->textureFileDatas = pixels; info->textureWidth = size; info->textureHeight = size; info->textureChannels = 4;
+    return true;
+}
+
+// Previews only need the first item of a playlist: .lsjb decodes item 0 straight from the mapping, and .lsjp parses
+// just the lines of the first ITEM holding rows, found the same way as the streaming indexer finds items.
+bool readFirstPresetItem(const std::string& path, WavePreset& bank) {
+    std::string error;
+    if (!hasExtension(path, ".lsjb") && !hasExtension(path, ".lsjp")) return readWaveBank(path, bank, error);
+    MappedFile file; if (!file.open(path)) return false;
+    if (hasExtension(path, ".lsjb")) {
+        LsjbHeader header; PlaylistItem item;
+        if (!validatePresetBinary(file, header, error) || header.itemCount == 0 || !decodePresetBinaryItem(file, header, 0, item, error)) return false;
+        bank = std::move(item.preset); return true;
+    }
+    const char* text = (const char*)file.data; size_t size = file.size;
+    auto nextLine = [text, size](size_t pos) { const char* newline = (const char*)std::memchr(text + pos, '\n', size - pos); return newline ? (size_t)(newline - text) + 1 : size; };
+    auto nextItem = [&](size_t pos) { while (pos < size && !(size - pos >= 4 && std::memcmp(text + pos, "ITEM", 4) == 0)) pos = nextLine(pos); return pos; };
+    for (size_t begin = nextItem(0); begin < size;) {
+        size_t end = nextItem(nextLine(begin));
+        std::vector<PlaylistItem> parsed; ParseError parseError;
+        if (!parsePlaylistFile(std::string_view(text + begin, end - begin), parsed, parseError)) return false;
+        if (!parsed.empty()) { bank = std::move(parsed[0].preset); return true; }
+        begin = end;
+    }
+    return false;
+}
+
+// Cache file: the key, a NUL, then the RGBA pixels. A file whose key differs is a hash collision or a stale size.
+bool readThumbnailFile(const std::string& path, const std::string& key, std::vector<unsigned char>& rgba) {
+    std::string data; if (!readFileToString(path, data)) return false;
+    if (data.size() != key.size() + 1 + rgba.size() || data.compare(0, key.size(), key) != 0 || data[key.size()] != '\0') return false;
+    std::memcpy(rgba.data(), data.data() + key.size() + 1, rgba.size());
+    return true;
+}
+
+bool writeThumbnailFile(const std::string& path, const std::string& key, const std::vector<unsigned char>& rgba) {
+    std::string temp = path + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb"); if (!file) return false;
+    std::fwrite(key.c_str(), 1, key.size() + 1, file); std::fwrite(rgba.data(), 1, rgba.size(), file);
+    if (std::fclose(file) != 0) return false;
+    std::error_code ec; std::filesystem::rename(temp, path, ec);
+    return !ec;
+}
+
+void createThumbnailTextureGL(IGFD_Thumbnail_Info* info) {
+    if (!info || !info->isReadyToUpload || !info->textureFileDatas) return;
+    GLuint tex; glGenTextures(1, &tex); glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, info->textureWidth, info->textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, info->textureFileDatas);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    delete[] info->textureFileDatas; info->textureFileDatas = nullptr;
+    info->textureID = (void*)(intptr_t)tex; info->isReadyToUpload = false; info->isReadyToDisplay = true;
+}
+
+void destroyThumbnailTextureGL(IGFD_Thumbnail_Info* info) {
+    if (!info || !info->textureID) return;
+    GLuint tex = (GLuint)(intptr_t)info->textureID; glDeleteTextures(1, &tex);
+    info->textureID = nullptr; info->isReadyToDisplay = false;
+}
+
+// LissGen export <wave.lsj|playlist.lsjp|preset.lsjb> <output folder> [--size N] [--fps N] [--format png|raw] [--seconds S] [--trail N] [--decimation N] [--line-width W]
+// Renders without audio or a GL context: every video frame synthesizes exactly the samples of its time slot, then rasterizes on the CPU.
+int runExportCommand(int argc, char* argv[]) {
+    if (argc < 4) { fprintf(stderr, "usage: %s export <wave.lsj|playlist.lsjp|preset.lsjb> <output folder> [--size N] [--fps N] [--format png|raw] [--seconds S] [--trail N] [--decimation N] [--line-width W]\n", argv[0]); return 1; }
+    std::string input = argv[2], outputDir = argv[3];
+    int size = 2160, fps = 60, format = CAPTURE_PNG; float seconds = 10.0f;
+    AudioState state;
+    for (int i = 4; i + 1 < argc; i += 2) {
+        std::string key = argv[i]; const char* value = argv[i + 1];
+        if (key == "--size") size = (std::max)(64, std::atoi(value));
+        else if (key == "--fps") fps = (std::max)(1, std::atoi(value));
+        else if (key == "--format") format = std::strcmp(value, "raw") == 0 ? CAPTURE_RAW : CAPTURE_PNG;
+        else if (key == "--seconds") seconds = (float)std::atof(value);
+        else if (key == "--trail") state.trailLength = (std::max)(2, std::atoi(value));
+        else if (key == "--decimation") state.decimator.factor = (std::max)(1, std::atoi(value));
+        else if (key == "--line-width") state.lineWidth = (float)std::atof(value);
+        else { fprintf(stderr, "unknown option %s\n", key.c_str()); return 1; }
+    }
+    // .lsjb holds either kind; its single-wave flag decides whether item durations or --seconds apply.
+    if (hasExtension(input, ".lsjb")) {
+        std::vector<PlaylistItem> items; bool singleWave = true;
+        if (!readPresetBinary(input, items, singleWave, state.parseErrorMsg)) state.parseErrorMsg = input + ": " + state.parseErrorMsg;
+        else if (!singleWave) state.playlist = std::move(items);
+        else if (!items.empty()) { items.resize(1); items[0].duration = seconds; state.playlist = std::move(items); }
+    }
+    else if (hasExtension(input, ".lsjp")) loadPlaylistFromFile(input, state);
+    else { loadWaveFromFile(input, state); if (!state.channelL.empty() || !state.channelR.empty()) { PlaylistItem item; item.preset.freqsL = state.channelL; item.preset.freqsR = state.channelR; item.duration = seconds; state.playlist.push_back(item); } }
+    if (state.playlist.empty()) { fprintf(stderr, "%s\n", state.parseErrorMsg.empty() ? ("nothing to render in " + input).c_str() : state.parseErrorMsg.c_str()); return 1; }
+
+    size_t capacity = (size_t)state.trailLength;
+    TrailRing trail(capacity); ScopeNormalizer normalizer(capacity);
+    ScopeRaster raster; raster.width = size; raster.height = size;
+    unsigned cores = std::thread::hardware_concurrency();
+    WorkerPool rasterPool(cores), encoders((std::max)(2u, cores / 2));
+    std::mutex bufferMutex; std::vector<std::vector<unsigned char>> freeBuffers;
+    std::atomic<int> failed{ 0 };
+    float pointRate = state.decimator.pointRate();
+    uint64_t sampleCursor = 0, frame = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int item = 0; item < (int)state.playlist.size(); item++) {
+        loadPlaylistItem(state, item); adoptPendingBank(state);
+        uint64_t itemFrames = (uint64_t)std::llround(state.playlist[item].duration * fps);
+        for (uint64_t f = 0; f < itemFrames; f++, frame++) {
+            uint64_t sampleEnd = (frame + 1) * SAMPLE_RATE / fps;
+            for (; sampleCursor < sampleEnd; sampleCursor++) {
+                float sampleL = synthesizeChannel(state.channelL), sampleR = synthesizeChannel(state.channelR);
+                float points[4]; int emitted = state.decimator.push(sampleL, sampleR, points);
+                for (int k = 0; k < emitted; k++) { trail.push(points[k * 2], points[k * 2 + 1]); normalizer.push(points[k * 2], points[k * 2 + 1], pointRate); }
+            }
+            size_t filled = (size_t)(std::min)(trail.head.load(), (uint64_t)capacity);
+            size_t numPoints = (std::max)((size_t)(filled * state.trailPercent / 100.0f), (size_t)2);
+            normalizer.window.store(numPoints);
+            TrailSpan span = trail.latest(numPoints);
+            std::vector<unsigned char> pixels;
+            { std::lock_guard<std::mutex> lock(bufferMutex); if (!freeBuffers.empty()) { pixels = std::move(freeBuffers.back()); freeBuffers.pop_back(); } }
+            pixels.resize((size_t)size * size * 4);
+            rasterizeScopeCPU(raster, &rasterPool, span.xy, span.count, normalizer.level.load(), state.lineWidth, state.showStartEndPoints, pixels.data());
+            char name[64]; std::snprintf(name, sizeof(name), "/frame_%06llu.%s", (unsigned long long)frame, format == CAPTURE_RAW ? "rgba" : "png");
+            std::string path = outputDir + name;
+            encoders.wait(CAPTURE_MAX_QUEUED);
+            encoders.submit([&, path, pixels = std::move(pixels)]() mutable {
+                if (!(format == CAPTURE_RAW ? writeRawFile(path, pixels.data(), size, size) : writePngFile(path, pixels.data(), size, size))) failed++;
+                std::lock_guard<std::mutex> lock(bufferMutex); freeBuffers.push_back(std::move(pixels));
+            });
+            if (frame % fps == 0) printf("frame %llu (%.1f s)\n", (unsigned long long)frame, (double)frame / fps);
+        }
+    }
+    encoders.wait();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printf("%llu frames in %.2f s (%.2fx real time), %d failed\n", (unsigned long long)frame, elapsed, elapsed > 0 ? frame / (double)fps / elapsed : 0.0, failed.load());
+    return failed.load() ? 1 : 0;
 }
 
 void loadPlaylistItem(AudioState& state, int index) {
     if (index < 0 || index >= (int)state.playlist.size()) return;
-    std::lock_guard<std::mutex> lock(state.bufferMutex);
-    const auto& item = state.playlist[index];
-    state.channelL = item.preset.freqsL;
-    state.channelR = item.preset.freqsR;
-    state.waveDataIsDirty = true;
+    publishBank(state, WavePreset(state.playlist[index].preset));
 }
\ No newline at end of file
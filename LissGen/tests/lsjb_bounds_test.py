@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+# Feeds .lsjb files with out-of-range header offsets to `LissGen convert` and checks that each one is
+# rejected as truncated instead of being read past the end of the mapping.
+# usage: lsjb_bounds_test.py <path to LissGen executable>
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+HEADER = struct.Struct("<4sIII6Q")  # LsjbHeader
+ITEM = struct.Struct("<QIIfI")      # LsjbItem
+U64_MAX = (1 << 64) - 1
+
+
+def build(rows=2, index=None, phase=None, freq=None, type_=None, mute=None):
+    index_offset = HEADER.size
+    phase_offset = index_offset + ITEM.size
+    freq_offset = phase_offset + rows * 8
+    type_offset = freq_offset + rows * 4
+    mute_offset = type_offset + rows
+    header = HEADER.pack(b"LSJB", 1, 1, 1, rows,
+                         index_offset if index is None else index,
+                         phase_offset if phase is None else phase,
+                         freq_offset if freq is None else freq,
+                         type_offset if type_ is None else type_,
+                         mute_offset if mute is None else mute)
+    body = ITEM.pack(0, 1, 1, 5.0, 0) + b"\0" * (rows * 8) + struct.pack("<2f", 440.0, 660.0) + b"\0" * (rows * 2)
+    return header + body
+
+
+CASES = {
+    "valid": (build(), True),
+    "index offset wraps": (build(index=U64_MAX - 7), False),
+    "phase offset wraps": (build(phase=U64_MAX - 15), False),
+    "freq offset wraps": (build(freq=U64_MAX - 3), False),
+    "type offset past end": (build(type_=U64_MAX), False),
+    "mute offset past end": (build(mute=1 << 40), False),
+    "row count overflows": (build(rows=2)[:16] + struct.pack("<Q", (1 << 61) + 1) + build(rows=2)[24:], False),
+}
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: lsjb_bounds_test.py <path to LissGen executable>")
+        return 2
+    exe, failures = sys.argv[1], 0
+    with tempfile.TemporaryDirectory() as tmp:
+        for name, (data, accepted) in CASES.items():
+            src, dst = os.path.join(tmp, "case.lsjb"), os.path.join(tmp, "case.lsjp")
+            with open(src, "wb") as f:
+                f.write(data)
+            run = subprocess.run([exe, "convert", src, dst], capture_output=True, text=True)
+            ok = (run.returncode == 0) if accepted else (run.returncode == 1 and "file is truncated" in run.stderr)
+            print(("PASS " if ok else "FAIL ") + name)
+            failures += not ok
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())